@@ -44,6 +44,7 @@ Test:
 curl -X PUT http://espASW01/api/v1/switch/0/Connected -d "ClientID=0&ClientTransactionID=0&Connected=true" (note cases)
 http://espASW01/api/v1/switch/0/status
 telnet espASW01 32272 (UDP)
+benchscript.sh espASW01 100 - latency per route from the client side, add PROFILE_HANDLERS for device-side figures at /profile
 
 Change Log
 19/10/2021 Updatees to normalise and fill out dependencies 
@@ -55,6 +56,11 @@ Change Log
 #define ESP8266_01
 //turns on debug output via debugStrings macros - either to serial or telnet if telnet is enabled. 
 #define DEBUG_ESP_MH  
+//MQTT topics to publish as packed binary rather than json - see Webrelay_telemetry.h and telemetry_decode.c
+//e.g. ( ( 1 << MQTT_TOPIC_HEALTH ) | ( 1 << MQTT_TOPIC_VOLTAGE ) | ( 1 << MQTT_TOPIC_SWITCH ) )
+#define MQTT_BINARY_TOPICS 0
+//Fill the /status time in per request so the cached copy is only rebuilt on a change of state - see Webrelay_status.h
+//#define STATUS_SPLICE_TIME
 //Use for client performance testing 
 #define DEBUG_ESP_HTTP_CLIENT
 //Manage the remote debug interface, it takes 6K of memory with all the strings 
@@ -66,6 +72,13 @@ Change Log
 //Turn on or off use of the ADC for voltage monitoring
 #define USE_ADC
 
+//Turn on per-route latency and heap profiling, reported at /profile. Use with benchscript.sh
+//#define PROFILE_HANDLERS
+
+//Serve the api and setup pages from the event driven server in Webrelay_async.h, needs ESPAsyncTCP.
+//Firmware updates move to UPDATE_SERVER_PORT
+//#define USE_ASYNC_SERVER
+
 #include "RemoteDebug.h"  //https://github.com/JoaoLopesF/RemoteDebug
 #include "DebugSerial.h"
 #include "SkybadgerStrings.h"
@@ -81,6 +94,7 @@ Change Log
 #include <WiFiUdp.h>      //WiFi UDP discovery responder
 #include <ESP8266WebServer.h>
 #include <ESP8266HTTPUpdateServer.h>
+#include "Webrelay_async.h"
 #include <ArduinoJson.h>  //https://arduinojson.org/v5/api/
 
 //Create a remote debug object
@@ -129,7 +143,13 @@ volatile bool callbackFlag = false;
 
 // Create an instance of the server
 // specify the port to listen on as an argument
-ESP8266WebServer server(80);
+#if defined USE_ASYNC_SERVER
+AsyncWebServerAdapter server(ALPACA_HTTP_PORT);
+ESP8266WebServer updateServer(UPDATE_SERVER_PORT);
+#else
+typedef ESP8266WebServer WebServerType;
+ESP8266WebServer server(ALPACA_HTTP_PORT);
+#endif
 ESP8266HTTPUpdateServer updater;
 
 //UDP Port can be edited in setup page
@@ -137,12 +157,10 @@ WiFiUDP Udp;
 
 //Hardware device system functions - reset/restart etc
 EspClass device;
-ETSTimer timer, timeoutTimer;
-volatile bool newDataFlag = false;
+ETSTimer timeoutTimer;
 volatile bool timeoutFlag = false;
 volatile bool timerSet = false;
 
-void onTimer(void);
 void onTimeoutTimer(void);
 void setupWifi( void );
 void setPins( void );
@@ -154,7 +172,7 @@ void publishADC( void );
 
 //Make these variables rather than constants to allow the custom setup to change them and store them to EEPROM
 int numSwitches = 0;
-SwitchEntry** switchEntry;
+SwitchEntry switchEntry[MAXSWITCH];
 
 //8-bit port control via I2C Port Expander PCF8574
 #include "PCF8574.h"
@@ -181,6 +199,7 @@ int adcChannel = 0;
 const int adcChannelMax = 4; //Physical max per device is 4, zero-indexed. 
 int adcGainSettings[ adcChannelMax ] = { 0,0,0,0, };
 uint16_t adcReading[4] = {0,0,0,0}; 
+int adcReadingGain[4] = {0,0,0,0};   //Gain setting adcReading was taken at - adcGainSettings may have moved on
 
 //ESPasw01
 //int lastChannel = 2;    //12v and 3v3
@@ -208,14 +227,24 @@ const int ADCGainSize = 6;
 const float adcGainFactor[] = { 0.003F, 0.002F, 0.001F, 0.0005F, 0.00025F, 0.000125F };
 #endif 
 
-const int eepromSize = 4 + (MAXSWITCH * MAX_NAME_LENGTH * 3) + (2* sizeof(int) )  + (MAXSWITCH * ( sizeof(SwitchEntry) + (2*MAX_NAME_LENGTH) ) ) + 10;
 
 //Order sensitive
 #include "Skybadger_common_funcs.h"
 #include "JSONHelperFunctions.h"
 #include "ASCOMAPICommon_rest.h" //From library/ASCOM_REST - ASCOM common driver descriptors and handlers. Override as required. 
+#include "Webrelay_journal.h"
 #include "Webrelay_eeprom.h"
+#include "Webrelay_relays.h"
+#include "Webrelay_adc.h"
+#include "Webrelay_json.h"
+#include "Webrelay_args.h"
+#include "Webrelay_profile.h"
+#include "Webrelay_mqttqueue.h"
+#include "Webrelay_discovery.h"
 #include "ESP8266_relayhandler.h"
+#include "Webrelay_status.h"
+#include "Webrelay_mqtt.h"
+#include "Webrelay_routes.h"
 #include "AlpacaManagement.h"
 
 void setup()
@@ -233,6 +262,8 @@ void setup()
   EEPROM.begin( eepromSize ); 
   //setDefaults();
   setupFromEeprom();
+  //A client's ETag from before a restart must not match by chance
+  stateGeneration = RANDOM_REG32;
   DEBUGSL1("Setup eeprom variables complete."); 
 
   // Connect to wifi 
@@ -241,13 +272,15 @@ void setup()
   //Open a connection to MQTT
   DEBUGSL1("Setting up MQTT."); 
   client.setServer( mqtt_server, 1883 );
-  String lastWillTopic = outHealthTopic; 
-  lastWillTopic.concat( myHostname );
-  client.connect( thisID, pubsubUserID, pubsubUserPwd, lastWillTopic.c_str(), 1, true, "disconnected" ); 
+  formatMqttTopics();
+  client.connect( thisID, pubsubUserID, pubsubUserPwd, mqttTopicHealth, 1, true, "disconnected" ); 
   //Create a timer-based callback that causes this device to read the local i2C bus devices for data to publish.
   client.setCallback( callback );
   client.subscribe( inTopic );
+  subscribeMqttCommands();
   publishHealth();
+  //Refresh the retained switch topics once connected
+  markAllSwitchPublish();
     
   //Pins mode and direction setup for i2c on ESP8266-01
   pinMode(0, OUTPUT);
@@ -332,103 +365,59 @@ void setup()
   // ads.setGain(GAIN_EIGHT);      // 8x gain   +/- 0.512V  1 bit = 0.25mV   0.015625mV
   // ads.setGain(GAIN_SIXTEEN);    // 16x gain  +/- 0.256V  1 bit = 0.125mV  0.0078125mV
   adc.begin();
-  adcPresent = true;//No function to allow us to sense the ADC. 
-  
-  //Something here is just not right. Not a fucking clue what. 
-  //symptom is I always end up with reading of 4095
-  int i, k;
-  for ( i = 0, k = 0; i <= lastChannel && i < adcChannelMax; i ++ )
-  {    
-     adcReading[i]=4095;
-     //We start from low gains and wide voltage ranges to high gains and small volts. 
-     while ( adcReading[i] >=4095 && k < ADCGainSize ) 
-     {
-        adcGainSettings[i] = k;
-        adc.setGain( adcGainConstants[k] );   
-        delay(15);        
-        adcReading[i] = adc.readADC_SingleEnded(i); 
-
-        debugI("ADC reading for channel %d is %d using gain setting %d and output %f\n", i, adcReading[i], adcGainFactor[ k ], adcReading[i]* adcGainFactor[ k ] ) ;
-        k++;
-        //otherwise try again  - increase the gain and see if we get a signal in the desired range. 
-        //If we fail we end up with the best gain by default because we saved it at the top of the loop anyway. 
-     }   
-     debugI("Final Gain setting for channel %d is %f\n", i, adcGainFactor[ adcGainSettings[i] ] ) ;
-  }
-  
+  //Gains are picked per conversion from here on - see Webrelay_adc.h
+  if ( adcBegin() )
+    DEBUG_ESP( "%s\n", "ADS1015 found" );
+  else
+    DEBUG_ESP( "%s\n", "ADS1015 not found - voltage monitoring disabled" );
 #endif 
 
   //Setup webserver handler functions
-  server.on("/", handlerStatus );
-  server.onNotFound(handlerNotFound); 
-  
-  //Common ASCOM handlers
-
-  //Generic ASCOM descriptor functions
-  server.on("/api/v1/switch/0/action",              HTTP_PUT, handleAction );
-  server.on("/api/v1/switch/0/commandblind",        HTTP_PUT, handleCommandBlind );
-  server.on("/api/v1/switch/0/commandbool",         HTTP_PUT, handleCommandBool );
-  server.on("/api/v1/switch/0/commandstring",       HTTP_PUT, handleCommandString );
-  server.on("/api/v1/switch/0/connected",           handleConnected );
-  server.on("/api/v1/switch/0/description",         HTTP_GET, handleDescriptionGet );
-  server.on("/api/v1/switch/0/driverinfo",          HTTP_GET, handleDriverInfoGet );
-  server.on("/api/v1/switch/0/driverversion",       HTTP_GET, handleDriverVersionGet );
-  server.on("/api/v1/switch/0/interfaceversion",    HTTP_GET, handleInterfaceVersionGet );
-  server.on("/api/v1/switch/0/name",                HTTP_GET, handleNameGet );
-  server.on("/api/v1/switch/0/supportedactions",    HTTP_GET, handleSupportedActionsGet );
-   
-  //Switch-specific functions
-  server.on("/api/v1/switch/0/maxswitch",           HTTP_GET, handlerDriver0Maxswitch );
-  server.on("/api/v1/switch/0/canwrite",            HTTP_GET, handlerDriver0CanWrite );
-  server.on("/api/v1/switch/0/getswitchdescription", HTTP_GET, handlerDriver0SwitchDescription );
-  server.on("/api/v1/switch/0/getswitch",           HTTP_GET, handlerDriver0SwitchState );
-  server.on("/api/v1/switch/0/setswitch",           HTTP_PUT, handlerDriver0SwitchState );
-  server.on("/api/v1/switch/0/getswitchname",       HTTP_GET, handlerDriver0SwitchName );
-  server.on("/api/v1/switch/0/setswitchname",       HTTP_PUT, handlerDriver0SwitchName );  
-  server.on("/api/v1/switch/0/getswitchvalue",      HTTP_GET, handlerDriver0SwitchValue );
-  server.on("/api/v1/switch/0/setswitchvalue",      HTTP_PUT, handlerDriver0SwitchValue );
-  server.on("/api/v1/switch/0/minswitchvalue",      HTTP_GET, handlerDriver0MinSwitchValue );
-  server.on("/api/v1/switch/0/maxswitchvalue",      HTTP_GET, handlerDriver0MaxSwitchValue );
-  server.on("/api/v1/switch/0/switchstep",          HTTP_GET, handlerDriver0SwitchStep );
+  //ASCOM driver api - all of /api/v1/switch/0/ is routed through the one table driven handler in Webrelay_routes.h
+  //Added first since the server tries handlers in the order they were added and these are the most frequent requests.
+  server.addHandler( &alpacaRequestHandler );
+  //The setup page, /setup/config and /status are cached by clients and revalidated against their ETag
+  const char* collectedHeaders[] = { "If-None-Match" };
+  server.collectHeaders( collectedHeaders, 1 );
+  profiledOn("/", handlerStatus );
+  server.onNotFound( withRequestArgs( handlerNotFound ) );
 
 //Additional ASCOM ALPACA Management setup calls
   //Per device
-  server.on("/setup",                               HTTP_GET, handlerDeviceSetup );
-  server.on("/setup/hostname" ,                     HTTP_ANY, handlerDeviceHostname );
-  server.on("/setup/udpport",                       HTTP_ANY, handlerDeviceUdpPort );
-  server.on("/setup/location",                      HTTP_ANY, handlerDeviceLocation );
+  profiledOn("/setup",                               HTTP_GET, handlerDeviceSetup );
+  profiledOn("/setup/config",                        HTTP_GET, handlerSetupConfig );
+  profiledOn("/setup/hostname" ,                     HTTP_ANY, handlerDeviceHostname );
+  profiledOn("/setup/udpport",                       HTTP_ANY, handlerDeviceUdpPort );
+  profiledOn("/setup/location",                      HTTP_ANY, handlerDeviceLocation );
+  profiledOn("/setup/flush",                         HTTP_ANY, handlerDeviceFlush );
   //TODO addd mqtt host and port settings. 
   
   //Management API
-  server.on("/management/apiversions",              HTTP_GET, handleMgmtVersions );
-  server.on("/management/v1/description",           HTTP_GET, handleMgmtDescription );
-  server.on("/management/v1/configureddevices",     HTTP_GET, handleMgmtConfiguredDevices );
-
-  server.on("/api/v1/switch/0/setup",               HTTP_GET, handlerDriver0Setup ); //ALPACA driver setup - as called by chooser
-  server.on("/api/v1/switch/0/getswitchtype",       HTTP_GET, handlerDriver0SwitchType );
-  server.on("/api/v1/switch/0/setswitchtype",       HTTP_ANY, handlerDriver0SwitchType );
-  server.on("/api/v1/switch/0/numswitches" ,        HTTP_ANY, handlerDriver0SetupNumSwitches );
-  server.on("/api/v1/switch/0/switches",            HTTP_ANY, handlerDriver0SetupSwitches );
-  
+  profiledOn("/management/apiversions",              HTTP_GET, handleMgmtVersions );
+  profiledOn("/management/v1/description",           HTTP_GET, handleMgmtDescription );
+  profiledOn("/management/v1/configureddevices",     HTTP_GET, handleMgmtConfiguredDevices );
+
   //Custom
-  server.on("/status",                              HTTP_GET, handlerStatus);
-  server.on("/restart",                             HTTP_ANY, handlerRestart);
+  profiledOn("/status",                              HTTP_GET, handlerStatus);
+  profiledOn("/restart",                             HTTP_ANY, handlerRestart);
+#if defined PROFILE_HANDLERS
+  server.on("/profile",                             HTTP_GET, withRequestArgs( handlerProfile ) );
+#endif
 
+#if defined USE_ASYNC_SERVER
+  updater.setup( &updateServer );
+  updateServer.begin();
+#else
   updater.setup( &server );
+#endif
   server.begin();
   DEBUG_ESP("%s\n", "Web server handlers setup & started" );
   
   //Starts the discovery responder server
-  Udp.begin( udpPort);
+  beginDiscovery();
   
   //Setup timers
-  //setup interrupt-based 'soft' alarm handler for periodic acquisition of new bearing
-  ets_timer_setfn( &timer, onTimer, NULL ); 
   ets_timer_setfn( &timeoutTimer, onTimeoutTimer, NULL ); 
-  
-  //fire timer every 500 msec
-  //Set the timer function first
-  ets_timer_arm_new( &timer, 500, 1/*repeat*/, 1);
   //ets_timer_arm_new( &timeoutTimer, 2500, 0/*one-shot*/, 1);
   
   //Show welcome message
@@ -449,48 +438,35 @@ void setPins( void )
   int i=0;
   for ( i=0; i< numSwitches ; i++ )
   {
-    switch (switchEntry[i]->type)
+    switch (switchEntry[i].type)
     {
       case SWITCH_PWM:
         //Set the pin modes and set the value in case they are newly chosen
-        if ( switchEntry[i]->pin != NULLPIN && switchEntry[i]->pin <= MINPIN && switchEntry[i]->pin <= MAXPIN ) 
-          analogWrite( switchEntry[i]->pin, (int) switchEntry[i]->value );
+        if ( switchEntry[i].pin != NULLPIN && switchEntry[i].pin <= MINPIN && switchEntry[i].pin <= MAXPIN ) 
+          analogWrite( switchEntry[i].pin, (int) switchEntry[i].value );
         break;
        
       case SWITCH_ANALG_DAC:
         //Not yet implemented - 
         //Needs an I2C DAC device 
-        //switchEntry[i]->value = switchEntry[i]->value; //TO do - read digital value back from pin ?
+        //switchEntry[i].value = switchEntry[i].value; //TO do - read digital value back from pin ?
         break;
       case SWITCH_RELAY_NC:       
       case SWITCH_RELAY_NO:
         //refresh the values and ?? pin modes in case they have changed types
         //If they have been used for analogue output (PWM) and then changed to digital - need to set them to 0 before use. 
-        analogWrite( switchEntry[i]->pin, 0);
+        analogWrite( switchEntry[i].pin, 0);
         //But since we use the I2C expander for the relay controls and not the local pins, might be able to ignore. 
-        //Relays use active low - which is the purpose of the reverseRelayLogic flag.
-        //If they read as high then they are not activated ...
-        if( reverseRelayLogic ) 
-        {
-          switchDevice.write( i, ! (bool) ( switchEntry[i]->value > 0.0F )  );
-          switchEntry[i]->value = ( switchDevice.read( i ) == 1 )? 0.0F: 1.0F ;
-        }
-        else
-        {
-          switchDevice.write( i, (bool) ( switchEntry[i]->value > 0.0F ) );
-          switchEntry[i]->value = ( switchDevice.read( i ) == 1 )? 1.0F: 0.0F ;
-        }
-        
+        //Relay levels are set below from the shadow register, including NO/NC and active low polarity.
       default:
         break;
     }
   }
-}
-
-//Timer handler for 'soft' 
-void onTimer( void * pArg )
-{
-  newDataFlag = true;
+  
+  //All relays in one bus write
+  refreshRelayOutputs();
+  relayDirty = true;
+  flushRelays();
 }
 
 //Used to complete timeout actions. 
@@ -504,32 +480,9 @@ void onTimeoutTimer( void* pArg )
 void loop()
 {
 #if defined USE_ADC 
-  int adcChannelIndex = 0;
+  //Sweeps the ADC channels on its own interval, a conversion per pass
+  serviceAdc();
 #endif
-  
-  if( newDataFlag == true ) 
-  {  
-#if defined USE_ADC 
-    //work out what gain to use that brings back the highest valid output
-    if ( adcPresent )
-    {
-      for ( adcChannelIndex = 0; adcChannelIndex <= lastChannel && adcChannelIndex < adcChannelMax; adcChannelIndex++ )
-      {
-        adc.setGain( adcGainConstants[ adcGainSettings[adcChannelIndex]] );
-        delay(15); //per channel
-        adcReading[adcChannelIndex] = adc.readADC_SingleEnded(adcChannelIndex);
-        DEBUG_ESP( "ADC value[%d]: %d", adcChannelIndex, adcReading[adcChannelIndex] );
-        debugV("Raw AIN[%d]: %i\n", adcChannelIndex, adcReading[adcChannelIndex] );
-        debugV("Processed AIN scaling: %3.3f, AIN gain:%f\n", adcScaleFactor[adcChannelIndex], adcGainFactor[ adcGainSettings[adcChannelIndex]] );
-        debugV("Processed AIN[%d]: %f\n", adcChannelIndex, adcReading[adcChannelIndex] * adcGainFactor[ adcGainSettings[adcChannelIndex]] / adcScaleFactor[adcChannelIndex] );
-        yield();       
-      }
-      debugV( "ratios of data presented: 0:1 %2.3f\n", (float) adcReading[0]/adcReading[1] );
-    }
-#endif     
-
-    newDataFlag = false;
-  }  
 
   if ( client.connected() )
   {
@@ -552,13 +505,32 @@ void loop()
     //reconnect();
     reconnectNB();
     client.subscribe( inTopic ) ; //Seems to be needed here. 
+    subscribeMqttCommands();
   }
+
+  //Switch commands received over MQTT
+  serviceMqttCommands();
+
+  //Send what has been queued for the broker
+  serviceMqttQueue();
   
   //Handle web requests
   server.handleClient();
+#if defined USE_ASYNC_SERVER
+  updateServer.handleClient();
+#endif
+
+  //Push any relay changes made by the handlers out to the expander
+  flushRelays();
+
+  //Publish switch changes once they have settled
+  serviceSwitchPublish();
+
+  //Commit setup changes once they have settled
+  serviceEeprom();
 
   //Check for Discovery packets
-  handleManagement();
+  serviceDiscovery();
 
 #if !defined DEBUG_DISABLED
   //Handle remote telnet debug session
@@ -566,6 +538,19 @@ void loop()
 #endif
 }
 
+/*
+ * Anything that has to follow switch state changes hangs off here. 
+ */
+void onSwitchValueChanged( int id )
+{
+  //Survive a restart without re-writing the EEPROM sector
+  journalAppend( id, switchEntry[id].value );
+  //Dashboards follow the retained switch topics
+  markSwitchPublish( id );
+  //Pollers holding the old /status see it has changed
+  stateGeneration++;
+}
+
 /* MQTT callback for subscription and topic.
  * Only respond to valid states ""
  * Publish under ~/skybadger/sensors/<sensor type>/<host>
@@ -573,6 +558,10 @@ void loop()
  */
 void callback(char* topic, byte* payload, unsigned int length) 
 {  
+  //Switch commands are copied out here and carried out from the loop
+  if ( queueMqttCommand( topic, payload, length ) )
+    return;
+
   //set callback flag
   callbackFlag = true;  
 }
@@ -580,56 +569,73 @@ void callback(char* topic, byte* payload, unsigned int length)
 #if defined USE_ADC 
  void publishADC( void )
  {
-  String outTopic;
-  String output;
-  String timestamp;
-  bool pubState = false;
-  
-  //publish to our device topic(s)
-  DynamicJsonBuffer jsonBuffer(256);
+  char timestamp[ MQTT_TIMESTAMP_LENGTH ];
+  JsonWriter json( mqttPublishBuffer, sizeof( mqttPublishBuffer ) );
+  int i = 0;
   
   debugI( "Publish ADC entered, adcPresent:  %i\n", adcPresent );
-  if( adcPresent )
-  {
-    int i=0;
-    String timestamp;
-    JsonObject& root = jsonBuffer.createObject();
-    output="";//reset
+  if( !adcPresent )
+    return;
 
-    outTopic = String(outSenseTopic); //P_STRING
-    outTopic.concat("voltage/");
-    outTopic.concat(myHostname);
-
-    getTimeAsString2( timestamp );
-    root["time"] = timestamp;
-    root["hostname"] = myHostname;
+  if( mqttBinaryTopic( MQTT_TOPIC_VOLTAGE ) )
+  {
+    TelemetryVoltage msg;
+    for( i = 0; i < lastChannel && i < adcChannelMax && i < TELEMETRY_MAX_ADC_CHANNELS; i++ )
+    {
+      TelemetryChannel& ch = msg.channel[i];
+      ch.millivolts = adcMillivolts[i];
+      ch.meanMv     = adcWindowMean( adcWindow[i] );
+      ch.minMv      = adcWindowMin( adcWindow[i] );
+      ch.maxMv      = adcWindowMax( adcWindow[i] );
+      ch.raw        = adcReading[i];
+      ch.gain       = (uint8_t) adcReadingGain[i];
+    }
+    msg.channels = (uint8_t) i;
+    size_t length = offsetof( TelemetryVoltage, channel ) + i * sizeof( TelemetryChannel );
+    telemetryHeader( msg.header, TELEMETRY_VOLTAGE, length );
+    enqueueMqtt( MQTT_TOPIC_VOLTAGE, 0, (const char*) &msg, length, true );
+    return;
+  }
 
-    JsonArray& voltages = root.createNestedArray( "voltages" );
-    for( i = 0; i < lastChannel; i++ )
+  json.beginObject();
+  json.add( "time", mqttTimestamp( timestamp, sizeof( timestamp ) ) );
+  json.add( "hostname", myHostname );
+  json.beginArray( "voltages" );
+  for( i = 0; i < lastChannel; i++ )
+  {
+    json.beginObject();
+    json.add( "adcReading", (double) adcReading[i] );
+    json.add( "adcScale",   (double) adcScaleFactor[i] );
+    json.add( "adcGain",    (double) adcGainFactor[ adcReadingGain[i] ] );
+    //Over the rolling window of samples
+    json.add( "voltageMean", (double) adcVolts( adcWindowMean( adcWindow[i] ) ) );
+    json.add( "voltageMin",  (double) adcVolts( adcWindowMin( adcWindow[i] ) ) );
+    json.add( "voltageMax",  (double) adcVolts( adcWindowMax( adcWindow[i] ) ) );
+    json.add( "samples",     (int) adcWindow[i].count );
+    switch (i) 
     {
-      JsonObject& entry = jsonBuffer.createObject();
-      entry["adcReading"] = (float) adcReading[i];
-      entry["adcScale"]   = (float) adcScaleFactor[i];
-      entry["adcGain"]    = (float) adcGainFactor[ adcGainSettings[i] ];
-      switch (i) 
-      {
-        case 0: entry["12v Voltage"] = (float) ( adcReading[i] * adcGainFactor[adcGainSettings[i]] * adcScaleFactor[i] ) ;
-          break;
-        case 1: entry["5v Voltage"] =  (float) ( adcReading[i] * adcGainFactor[adcGainSettings[i]] * adcScaleFactor[i] );
-          break;
-        case 2: entry["3v3 Voltage"] = (float) ( adcReading[i] * adcGainFactor[adcGainSettings[i]] * adcScaleFactor[i] );
-          break;
-        case 3: entry["Raw Voltage"] = (float) ( adcReading[i] * adcGainFactor[adcGainSettings[i]] * adcScaleFactor[i] ); 
-          break;
-        default:
-          break;
-      }
-      voltages.add( entry );
-    }   
-    root.printTo( output );
-    pubState = client.publish( outTopic.c_str(), output.c_str(), true );
-    debugI( "topic : %s published with values: %s\n", outTopic.c_str(),  output.c_str() );
+      case 0: json.add( "12v Voltage", (double) adcVolts( adcMillivolts[i] ) );
+        break;
+      case 1: json.add( "5v Voltage",  (double) adcVolts( adcMillivolts[i] ) );
+        break;
+      case 2: json.add( "3v3 Voltage", (double) adcVolts( adcMillivolts[i] ) );
+        break;
+      case 3: json.add( "Raw Voltage", (double) adcVolts( adcMillivolts[i] ) ); 
+        break;
+      default:
+        break;
+    }
+    json.endObject();
+  }   
+  json.endArray();
+  json.endObject();
+  if ( json.overflowed() )
+  {
+    DEBUGSL1( "publishADC: message too long for the publish buffer" );
+    return;
   }
+  enqueueMqtt( MQTT_TOPIC_VOLTAGE, 0, json.c_str(), json.length(), true );
+  debugI( "topic : %s queued with values: %s\n", mqttTopicVoltage, json.c_str() );
  }
 #endif //USE_ADC
 
@@ -642,27 +648,31 @@ void callback(char* topic, byte* payload, unsigned int length)
  */
  void publishHealth( void )
  {
-  String outTopic;
-  String output;
-  String timestamp;
+  char timestamp[ MQTT_TIMESTAMP_LENGTH ];
+  JsonWriter json( mqttPublishBuffer, sizeof( mqttPublishBuffer ) );
   
-  //checkTime();
-  getTimeAsString2( timestamp );
+  if ( mqttBinaryTopic( MQTT_TOPIC_HEALTH ) )
+  {
+    TelemetryHealth msg;
+    telemetryHeader( msg.header, TELEMETRY_HEALTH, sizeof( msg ) );
+    msg.uptime = millis() / 1000;
+    msg.freeHeap = device.getFreeHeap();
+    msg.mqttDropped = mqttQueueDropped;
+    enqueueMqtt( MQTT_TOPIC_HEALTH, 0, (const char*) &msg, sizeof( msg ), true );
+    return;
+  }
 
   //publish to our device topic(s)
-  DynamicJsonBuffer jsonBuffer(256);
-  JsonObject& root = jsonBuffer.createObject();
-  root["time"] = timestamp;
-  root["hostname"] = myHostname;
-  root["message"] = "Listening";
-  
-  root.printTo( output);
+  json.beginObject();
+  json.add( "time", mqttTimestamp( timestamp, sizeof( timestamp ) ) );
+  json.add( "hostname", myHostname );
+  json.add( "message", "Listening" );
+  json.add( "mqttDropped", (unsigned long) mqttQueueDropped );
+  json.endObject();
   
   //Put a notice out regarding device health
-  outTopic = String( outHealthTopic );
-  outTopic.concat( myHostname );
-  client.publish( outTopic.c_str(), output.c_str(), true );  
-  debugI( "topic: %s, published with value %s \n", outTopic.c_str(), output.c_str() );
+  enqueueMqtt( MQTT_TOPIC_HEALTH, 0, json.c_str(), json.length(), true );
+  debugI( "topic: %s, queued with value %s \n", mqttTopicHealth, json.c_str() );
  }
 
 void setupWifi( void )
@@ -34,6 +34,10 @@ Internally this code keeps the state of the switch in the switchEntry structure
 #define _ESP8266_RELAYHANDLER_H_
 
 #include "Webrelay_eeprom.h"
+#include "Webrelay_relays.h"
+#include "Webrelay_json.h"
+#include "Webrelay_args.h"
+#include "Webrelay_setuppage.h"
 #include <Wire.h>
 #include "AlpacaErrorConsts.h"
 #include "ASCOMAPISwitch_rest.h"
@@ -41,37 +45,34 @@ Internally this code keeps the state of the switch in the switchEntry structure
 //Function definitions
 void copySwitch( SwitchEntry* sourceSe, SwitchEntry* targetSe );
 void initSwitch( SwitchEntry* targetSe );
-SwitchEntry** reSize( SwitchEntry** old, int newSize );
+void reSize( int newSize );
 bool getUriField( char* inString, int searchIndex, String& outRef );
 
-//Deprecated in favour of splitting up in to separate chunks. 
-//String& setupFormBuilder( String& htmlForm, String& errMsg );
-
-String& setupFormBuilderHeader( String& htmlForm );
-String& setupFormBuilderDeviceHeader( String& htmlForm, String& errMsg ); //For device setup
-String& setupFormBuilderDeviceStrings( String& htmlForm );
-String& setupFormBuilderDriverHeader( String& htmlForm, String& errMsg ); //For per-driver setup when we have 1 or more drivers attached
-String& setupFormBuilderDriver0Switches( String& htmlForm, int index );
-String& setupFormBuilderFooter( String& htmlForm );
+//Setup page
+void sendSetupPage(void);
+void sendSetupResult( int returnCode, const String& err );
+void handlerSetupConfig(void);
 
 //Device settings
-void sendDeviceSetup( int returnCode, String& message, String& err );
 void handlerDeviceSetup(void);
 void handlerDeviceHostname(void);
 void handlerDeviceLocation(void);
 void handlerDeviceUdpPort(void);
+void handlerDeviceFlush(void);
 
 //Driver0 settings
-void sendDriver0Setup( int returnCode, String& message, String& err );
 void handlerDriver0Setup(void);
 void handlerDriver0SetupNumSwitches(void);
 void handlerDriver0Maxswitch(void);
 void handlerDriver0CanWrite(void);
+int applySwitchState( AlpacaResponse& resp, int switchID, bool state, long level );
+int applySwitchValue( AlpacaResponse& resp, int switchID, float value );
 void handlerDriver0SwitchState(void);
 void handlerDriver0SwitchDescription(void);
 void handlerDriver0SwitchName(void);
 void handlerDriver0SwitchType(void);
 void handlerDriver0SwitchValue(void);
+void handlerDriver0SetSwitches(void);
 void handlerDriver0MinSwitchValue(void);
 void handlerDriver0MaxSwitchValue(void);
 void handlerDriver0SwitchStep(void);
@@ -101,12 +102,8 @@ void copySwitch( SwitchEntry* sourceSe, SwitchEntry* targetSe )
 
 void initSwitch( SwitchEntry* targetSe )
 {
-    String output;
-    output = "Default description";
-    strncpy( targetSe->description, output.c_str(), MAX_NAME_LENGTH);
-
-    output = "Switch Name";
-    strncpy( targetSe->switchName, output.c_str(), MAX_NAME_LENGTH);
+    strncpy( targetSe->description, "Default description", MAX_NAME_LENGTH);
+    strncpy( targetSe->switchName, "Switch Name", MAX_NAME_LENGTH);
 
     targetSe->writeable   = true;
     targetSe->type        = SWITCH_RELAY_NO;
@@ -117,52 +114,21 @@ void initSwitch( SwitchEntry* targetSe )
     targetSe->pin         = NULLPIN;
 }
 /*
- * This function re-sizes the existing switchEntry array by re-allocating memory and copying if required. 
- * returns pointer to array of switches
+ * This function re-sizes the in-use part of the switchEntry table. 
+ * Entries brought into use are set to defaults, those dropped are left as they are. 
  */
-SwitchEntry** reSize( SwitchEntry** old, int newSize )
+void reSize( int newSize )
 {
   int i=0;
-  SwitchEntry* newse;
-  SwitchEntry** pse = (SwitchEntry** ) calloc( sizeof (SwitchEntry*),  newSize );
   
   DEBUGS1( "reSize called: " );DEBUGSL1( newSize );
-
-  if ( newSize < numSwitches )
-  {
-    for ( i=0 ; i < newSize; i++ )
-      pse[i] = old[i];      
-    //Handle the remaining 
-    for ( ; i < numSwitches; i++ )
-    {
-      if( old[i]->description != nullptr ) 
-        free( old[i]->description );
-      if( old[i]->switchName != nullptr ) free( old[i]->switchName );
-        free( old[i] );
-    }
-  }
-  else if ( newSize == numSwitches)
+  for ( i = numSwitches; i < newSize; i++ )
   {
-    //do nothing
-    free(pse);
-    pse = old;
-  }
-  else //bigger than before
-  {
-    for ( i = 0; i < numSwitches; i++ )
-       pse[i] = old[i];      
-    for ( ; i < newSize; i++ )
-    {
-      newse = (SwitchEntry*) calloc( sizeof (SwitchEntry), 1 );
-      newse->description = (char*)calloc( MAX_NAME_LENGTH, sizeof(char) );
-      newse->switchName = (char*)calloc( MAX_NAME_LENGTH, sizeof(char) );
-      pse[i] = newse;
-      initSwitch( newse );
-    }
+    initSwitch( &switchEntry[i] );
+    markSwitchDirty( i );
   }
   numSwitches = newSize;
   DEBUGS1("reSize completed, numSwitches updated to");DEBUGSL1(newSize);
-  return pse;
 }
 
 bool getUriField( char* inString, int searchIndex, String& outRef )
@@ -198,17 +164,14 @@ bool getUriField( char* inString, int searchIndex, String& outRef )
 //The number of switch devices managed by this driver
 void handlerDriver0Maxswitch(void)
 {
-    String message;
-    uint32_t clientID = (uint32_t)server.arg("ClientID").toInt();
-    uint32_t transID = (uint32_t)server.arg("ClientTransactionID").toInt();
-
-    DynamicJsonBuffer jsonBuffer(256);
-    JsonObject& root = jsonBuffer.createObject();
-    jsonResponseBuilder( root, clientID, transID, serverTransID++, "MaxSwitch", Success , "" );    
-    root["Value"] = numSwitches;
+    uint32_t clientID = (uint32_t) requestArgs.getInt( ARG_CLIENT_ID );
+    uint32_t transID = (uint32_t) requestArgs.getInt( ARG_CLIENT_TRANS_ID );
+
+    AlpacaResponse root;
+    alpacaResponseBuilder( root, clientID, transID, serverTransID++, "MaxSwitch", Success , "" );    
+    alpacaValue( root, numSwitches );
     
-    root.printTo(message);
-    server.send(200, "application/json", message);
+    sendAlpacaResponse( 200, root );
     return ;
 }
 
@@ -216,71 +179,150 @@ void handlerDriver0Maxswitch(void)
 //Indicates whether the specified switch device can be written to
 void handlerDriver0CanWrite(void)
 {
-    String message;
-    uint32_t clientID = (uint32_t)server.arg("ClientID").toInt();
-    uint32_t transID = (uint32_t)server.arg("ClientTransactionID").toInt();
+    uint32_t clientID = (uint32_t) requestArgs.getInt( ARG_CLIENT_ID );
+    uint32_t transID = (uint32_t) requestArgs.getInt( ARG_CLIENT_TRANS_ID );
     int statusCode = 400;
     int switchID = -1;
-    String argToSearchFor = "Id";
 
-    DynamicJsonBuffer jsonBuffer(256);
-    JsonObject& root = jsonBuffer.createObject();
-    jsonResponseBuilder( root, clientID, transID, serverTransID++, "CanWrite", Success , "" );    
+    AlpacaResponse root;
+    alpacaResponseBuilder( root, clientID, transID, serverTransID++, "CanWrite", Success , "" );    
 
-    if( hasArgIC( argToSearchFor, server, false ) )
+    if( requestArgs.has( ARG_ID ) )
     {
-      switchID = server.arg(argToSearchFor).toInt();
+      switchID = requestArgs.getInt( ARG_ID );
       if ( switchID >= 0 && switchID < numSwitches ) 
       {
-        root["Value"] = switchEntry[switchID]->writeable;
+        alpacaValue( root, switchEntry[switchID].writeable );
         statusCode = 200;
       }
       else
       {
         statusCode = 400;
-        root["ErrorMessage"] = "Argument switch Id out of range";
-        root["ErrorNumber"] = (int) invalidValue ; 
+        alpacaError( root, (int) invalidValue, "Argument switch Id out of range" );
       }
     }
     else
     {
         statusCode = 400;
-        root["ErrorMessage"] = "Missing switchID argument";
-        root["ErrorNumber"] = (int) invalidOperation ;       
+        alpacaError( root, (int) invalidOperation, "Missing switchID argument" );
     }
-    root.printTo(message);
-    server.send( statusCode , "application/json", message);
+    sendAlpacaResponse( statusCode, root );
     return ;
 }
 
+/*
+ * Set a switch from a boolean state - the PUT side of setswitch, shared with the MQTT command topic.
+ * Relays take the state, PWM switches take the level. Errors are set on resp; returns the http status to use.
+ */
+int applySwitchState( AlpacaResponse& resp, int switchID, bool state, long level )
+{
+    if ( switchID < 0 || switchID >= numSwitches )
+    {
+      alpacaError( resp, invalidValue, "Invalid switch ID as argument" );
+      return 400;
+    }
+
+    switch( switchEntry[switchID].type )
+    {
+      case SWITCH_RELAY_NO:
+      case SWITCH_RELAY_NC:
+          DEBUGSL1( "Found relay to set");
+          //Written to the expander before replying so a failed bus write is reported, as setswitches does
+          setRelayState( switchID, state );
+          if ( !flushRelays() )
+          {
+            alpacaError( resp, invalidOperation, "Relay bus write failed" );
+            return 500;
+          }
+          return 200;
+      case SWITCH_PWM:
+          DEBUGSL1( "Found PWM to set");
+          switchEntry[switchID].value = (float) level;
+          onSwitchValueChanged( switchID );
+          return 200;
+      case SWITCH_ANALG_DAC:
+      default:
+        alpacaError( resp, invalidOperation, "Invalid state for non-boolean switch type" );
+        return 400;
+    }
+}
+
+/*
+ * Set a switch from an analogue value - the PUT side of setswitchvalue, shared with the MQTT command topic.
+ * Errors are set on resp; returns the http status to use.
+ */
+int applySwitchValue( AlpacaResponse& resp, int switchID, float value )
+{
+    int returnCode = 200;
+
+    if ( switchID < 0 || switchID >= numSwitches )
+    {
+      alpacaError( resp, invalidValue, "SwitchID value out of range." );
+      return 200;
+    }
+
+    switch( switchEntry[switchID].type ) 
+    {
+      case SWITCH_PWM: 
+            if ( value >= switchEntry[switchID].min && 
+                 value <= switchEntry[switchID].max )
+            {
+              switchEntry[switchID].value = value;
+              onSwitchValueChanged( switchID );
+              analogWrite( switchEntry[switchID].pin, switchEntry[switchID].value );
+              returnCode = 200;
+            }
+            else
+            {
+              alpacaError( resp, invalidOperation, "Digital write out of range for switch in PWM mode" );
+              returnCode = 200;
+            }                  
+            break;
+            
+      case SWITCH_RELAY_NO:
+      case SWITCH_RELAY_NC:
+            returnCode = 400;
+            alpacaError( resp, invalidOperation, "Invalid analogue operation for binary/boolean switch type" );
+            break;
+      case SWITCH_ANALG_DAC:
+            if ( value >= switchEntry[switchID].min && 
+                 value <= switchEntry[switchID].max )
+            {
+              switchEntry[switchID].value = value;
+              onSwitchValueChanged( switchID );
+              //e.g. analogue_write( switchEntry[switchID].value, switchEntry[switchID].pin );
+              alpacaError( resp, invalidOperation, "DAC Not implemented yet - Invalid digital operation for switch" );
+            }
+            returnCode = 200;
+            break;
+      default:
+        break;
+    }
+    return returnCode;
+}
+
 //GET ​/switch​/{device_number}​/getswitch
 //PUT ​/switch​/{device_number}​/setswitch
 //Get/Set the state of switch device id as a boolean - treats as binary
 void handlerDriver0SwitchState(void)
 {
-    String message;
-    uint32_t clientID = (uint32_t)server.arg("ClientID").toInt();
-    uint32_t transID = (uint32_t)server.arg("ClientTransactionID").toInt();
+    uint32_t clientID = (uint32_t) requestArgs.getInt( ARG_CLIENT_ID );
+    uint32_t transID = (uint32_t) requestArgs.getInt( ARG_CLIENT_TRANS_ID );
     int returnCode = 200;
     double switchValue; 
     bool bValue;
-    bool newState = false;
     int switchID = -1;
-    String argToSearchFor[2] = {"Id", "State"};
     
-    DynamicJsonBuffer jsonBuffer(256);
-    JsonObject& root = jsonBuffer.createObject();
-    jsonResponseBuilder( root, clientID, transID, serverTransID++, "SwitchState", Success , "" );    
+    AlpacaResponse root;
+    alpacaResponseBuilder( root, clientID, transID, serverTransID++, "SwitchState", Success , "" );    
 
-    if( hasArgIC( argToSearchFor[0], server, false ) )
-      switchID = server.arg( argToSearchFor[0] ).toInt();
+    if( requestArgs.has( ARG_ID ) )
+      switchID = requestArgs.getInt( ARG_ID );
     else
     {
-       String output = "Missing argument: switchID";
-       root["ErrorNumber"] = invalidOperation;
-       root["ErrorMessage"] = output; 
+       alpacaError( root, invalidOperation, "Missing argument: switchID" );
        returnCode = 400;
-       server.send(returnCode, "application/json", message);
+       sendAlpacaResponse( returnCode, root );
        return;
     }
  
@@ -289,86 +331,51 @@ void handlerDriver0SwitchState(void)
     {
       if( server.method() == HTTP_GET  )
       {
-        switch ( switchEntry[switchID]->type ) 
+        switch ( switchEntry[switchID].type ) 
         {
           case SWITCH_RELAY_NO:
           case SWITCH_RELAY_NC:
-            switchValue = switchEntry[switchID]->value;
+            switchValue = switchEntry[switchID].value;
             if ( switchValue != 1.0F ) 
               bValue = false;
             else 
               bValue = true;      
-            root["Value"] =  bValue;  
+            alpacaValue( root, bValue );  
             returnCode = 200;
             break;
           case SWITCH_PWM:
-            switchValue = switchEntry[switchID]->value;
+            switchValue = switchEntry[switchID].value;
             bValue = false;
-            root["Value"] =  switchValue;  
+            alpacaValue( root, switchValue );  
             returnCode = 200;
             break;          
           case SWITCH_ANALG_DAC:
           default:
             returnCode = 400;
-            root["ErrorMessage"] = "Invalid state retrieval for switch type - not boolean"  ;
-            root["ErrorNumber"] = invalidValue ;
+            alpacaError( root, invalidValue, "Invalid state retrieval for switch type - not boolean" );
           break;
         }
       }
-      else if (server.method() == HTTP_PUT && hasArgIC( argToSearchFor[1], server, false ) )
+      else if (server.method() == HTTP_PUT && requestArgs.has( ARG_STATE ) )
       {
-        switch( switchEntry[switchID]->type )
-        {
-          case SWITCH_RELAY_NO:
-          case SWITCH_RELAY_NC:
-              DEBUGSL1( "Found relay to set");
-              if( server.arg( argToSearchFor[1] ).equalsIgnoreCase( "true" ) )
-                newState = true;
-              else
-                newState = false;
-              if( reverseRelayLogic )
-                switchDevice.write( switchID, (newState) ? 0 : 1 );
-              else
-                switchDevice.write( switchID, (newState) ? 1 : 0 );
-              switchEntry[switchID]->value = (newState)? 1.0F : 0.0F;
-              returnCode = 200;              
-            break;
-          case SWITCH_PWM:
-              DEBUGSL1( "Found PWM to set");
-              switchValue = server.arg( argToSearchFor[1] ).toInt();
-              switchEntry[switchID]->value = switchValue;
-              returnCode = 200;              
-            break;
-          
-          case SWITCH_ANALG_DAC:
-          default:
-            returnCode = 400;
-            root["ErrorMessage"] = "Invalid state for non-boolean switch type"  ;
-            root["ErrorNumber"] = invalidOperation ;
-            break;
-        }
+        returnCode = applySwitchState( root, switchID, requestArgs.isTrue( ARG_STATE ), requestArgs.getInt( ARG_STATE ) );
       } 
       else
       {
-         String output = "";
+         char output[32];
          Serial.println( "Error: method not available" );
-         root["ErrorNumber"] = invalidOperation;
-         output = "http verb:";
-         output += server.method();
-         output += " not available";
-         root["ErrorMessage"] = output; 
+         snprintf( output, sizeof(output), "http verb:%d not available", (int) server.method() );
+         alpacaError( root, invalidOperation, output );
          returnCode = 400;
       }  
     }
     else
     {
         returnCode = 400;
-        root["ErrorMessage"] = "Invalid switch ID as argument";
-        root["ErrorNumber"] = invalidValue ;
+        alpacaError( root, invalidValue, "Invalid switch ID as argument" );
     }
 
-    root.printTo(message);
-    server.send(returnCode, "application/json", message);
+    sendAlpacaResponse( returnCode, root );
     return;
 }
 
@@ -376,38 +383,32 @@ void handlerDriver0SwitchState(void)
 //Gets the description of the specified switch device
 void handlerDriver0SwitchDescription(void)
 {
-    String message;
-    uint32_t clientID = (uint32_t)server.arg("ClientID").toInt();
-    uint32_t transID = (uint32_t)server.arg("ClientTransactionID").toInt();
+    uint32_t clientID = (uint32_t) requestArgs.getInt( ARG_CLIENT_ID );
+    uint32_t transID = (uint32_t) requestArgs.getInt( ARG_CLIENT_TRANS_ID );
     int returnCode = 200;
-    String argToSearchFor = "Id";
     int switchID = -1;
           
-    DynamicJsonBuffer jsonBuffer(256);
-    JsonObject& root = jsonBuffer.createObject();
-    jsonResponseBuilder( root, clientID, transID, serverTransID++, "SwitchDescription", Success, "" );    
+    AlpacaResponse root;
+    alpacaResponseBuilder( root, clientID, transID, serverTransID++, "SwitchDescription", Success, "" );    
 
-    if( hasArgIC( argToSearchFor, server, false ) )
+    if( requestArgs.has( ARG_ID ) )
     {
-      switchID = server.arg( argToSearchFor ).toInt();
+      switchID = requestArgs.getInt( ARG_ID );
       if( switchID >=0 && switchID < numSwitches )
-          root["Value"] = switchEntry[switchID]->description;
+          alpacaValue( root, switchEntry[switchID].description );
       else
       {
-         root["ErrorNumber"] = invalidValue;
-         root["ErrorMessage"] = "Out of range argument: switchID"; 
+         alpacaError( root, invalidValue, "Out of range argument: switchID" );
          returnCode = 400;    
       }
     }  
     else
     {
-       root["ErrorNumber"] = invalidOperation;
-       root["ErrorMessage"] = "Missing argument: switchID"; 
+       alpacaError( root, invalidOperation, "Missing argument: switchID" );
        returnCode = 400;    
     }
 
-    root.printTo(message);
-    server.send(returnCode, "application/json", message);
+    sendAlpacaResponse( returnCode, root );
     return;
 }
 
@@ -416,70 +417,60 @@ void handlerDriver0SwitchDescription(void)
 //Get/set the name of the specified switch device
 void handlerDriver0SwitchName(void)
 {
-    String message;
-    uint32_t clientID = (uint32_t)server.arg("ClientID").toInt();
-    uint32_t transID = (uint32_t)server.arg("ClientTransactionID").toInt();
+    uint32_t clientID = (uint32_t) requestArgs.getInt( ARG_CLIENT_ID );
+    uint32_t transID = (uint32_t) requestArgs.getInt( ARG_CLIENT_TRANS_ID );
     int returnCode = 200;
     int switchID;
     String newName =  "";
-    String argToSearchFor[2] = {"Id", "Name"};
-    DynamicJsonBuffer jsonBuffer(256);
-    JsonObject& root = jsonBuffer.createObject();
-    jsonResponseBuilder( root, clientID, transID, serverTransID++, "SwitchName", Success, "" );    
+    AlpacaResponse root;
+    alpacaResponseBuilder( root, clientID, transID, serverTransID++, "SwitchName", Success, "" );    
     
-    if( hasArgIC( argToSearchFor[0], server, false ) )
+    if( requestArgs.has( ARG_ID ) )
     {
-      switchID = server.arg(argToSearchFor[0]).toInt();
+      switchID = requestArgs.getInt( ARG_ID );
       if ( switchID >= 0 && switchID < numSwitches  )
       {
         if ( server.method() == HTTP_GET )
         {
-            root["Value"] = switchEntry[switchID]->switchName;
+            alpacaValue( root, switchEntry[switchID].switchName );
             returnCode = 200;
         }
-        else if( server.method() == HTTP_PUT && hasArgIC( argToSearchFor[1], server, false ) )
+        else if( server.method() == HTTP_PUT && requestArgs.has( ARG_NAME ) )
         {
-            int sLen = strlen( server.arg( argToSearchFor[1] ).c_str() );
+            int sLen = strlen( requestArgs.value( ARG_NAME ).c_str() );
             if ( sLen > MAX_NAME_LENGTH -1 )
             {
-              root["ErrorMessage"]= "Switch name too long";
-              root["ErrorNumber"] = invalidValue ;
+              alpacaError( root, invalidValue, "Switch name too long" );
               returnCode = 400;
             }
             else
             {
-              if ( switchEntry[switchID]->switchName != nullptr ) 
-                free( switchEntry[switchID]->switchName );
-              switchEntry[switchID]->switchName  = (char*) calloc( MAX_NAME_LENGTH, sizeof(char) );
-              strcpy( switchEntry[switchID]->switchName, server.arg( argToSearchFor[1] ).c_str() );
+              strcpy( switchEntry[switchID].switchName, requestArgs.value( ARG_NAME ).c_str() );
+              markSwitchDirty( switchID );
             }                    
         }
         else
         {
            //Invalid http verb 
            returnCode = 400;
-           root["ErrorMessage"]= "Invalid HTTP verb found";
-           root["ErrorNumber"] = invalidOperation;
+           alpacaError( root, invalidOperation, "Invalid HTTP verb found" );
         }
       }
       else
       {
         //invalid switch id 
         returnCode = 400;
-        root["ErrorMessage"]= "Invalid switch ID - outside range";
-        root["ErrorNumber"] = invalidValue ;
+        alpacaError( root, invalidValue, "Invalid switch ID - outside range" );
       }
     }
     else
     {
       //invalid switch id 
       returnCode = 400;
-      root["ErrorMessage"]= "Missing switch ID";
-      root["ErrorNumber"] = invalidOperation ;
+      alpacaError( root, invalidOperation, "Missing switch ID" );
     }
 
-    root.printTo(message);
-    server.send(returnCode, "application/json", message);
+    sendAlpacaResponse( returnCode, root );
     return;
 }
 
@@ -489,28 +480,23 @@ void handlerDriver0SwitchName(void)
 //Get/set the name of the specified switch device
 void handlerDriver0SwitchType(void)
 {
-    String message;
-    uint32_t clientID = (uint32_t)server.arg("ClientID").toInt();
-    uint32_t transID = (uint32_t)server.arg("ClientTransactionID").toInt();
+    uint32_t clientID = (uint32_t) requestArgs.getInt( ARG_CLIENT_ID );
+    uint32_t transID = (uint32_t) requestArgs.getInt( ARG_CLIENT_TRANS_ID );
     int returnCode = 200;
     int switchID;
     String newName =  "";
-    String argToSearchFor[2] = {"Id", "Name"};
-    DynamicJsonBuffer jsonBuffer(256);
-    JsonObject& root = jsonBuffer.createObject();
-    jsonResponseBuilder( root, clientID, transID, serverTransID++, "SwitchType", 0, "" );    
+    AlpacaResponse root;
+    alpacaResponseBuilder( root, clientID, transID, serverTransID++, "SwitchType", 0, "" );    
     
-    if( hasArgIC( argToSearchFor[0], server, false ) )
+    if( requestArgs.has( ARG_ID ) )
     {
-      switchID = server.arg(argToSearchFor[0]).toInt();
+      switchID = requestArgs.getInt( ARG_ID );
     }  
     else
     {
        returnCode = 400;
-       root["ErrorMessage"]= "Missing switchID argument";
-       root["ErrorNumber"] = invalidValue ;     
-       root.printTo(message);
-       server.send(returnCode, "application/json", message);
+       alpacaError( root, invalidValue, "Missing switchID argument" );
+       sendAlpacaResponse( returnCode, root );
        return;
     }
      
@@ -518,36 +504,41 @@ void handlerDriver0SwitchType(void)
     {
       if ( server.method() == HTTP_GET )
       {
-          root["Value"] = switchEntry[switchID]->type;
+          alpacaValue( root, switchEntry[switchID].type );
       }
-      else if( server.method() == HTTP_PUT && hasArgIC( argToSearchFor[1], server, false ) )
+      else if( server.method() == HTTP_PUT && requestArgs.has( ARG_NAME ) )
       {
-          enum SwitchType newType = ( enum SwitchType ) server.arg(argToSearchFor[1]).toInt();          
+          enum SwitchType newType = ( enum SwitchType ) requestArgs.getInt( ARG_NAME );          
           switch( newType )
           {
           case SWITCH_RELAY_NO:
           case SWITCH_RELAY_NC:
-              switchEntry[switchID]->type = (enum SwitchType) newType;
-              switchEntry[switchID]->min =  MINVAL;
-              switchEntry[switchID]->max =  MAXBINARYVAL;
-              switchEntry[switchID]->step = MAXBINARYVAL;
+              switchEntry[switchID].type = (enum SwitchType) newType;
+              switchEntry[switchID].min =  MINVAL;
+              switchEntry[switchID].max =  MAXBINARYVAL;
+              switchEntry[switchID].step = MAXBINARYVAL;
+              markSwitchDirty( switchID );
+              //NO/NC changes the polarity of this relay
+              refreshRelayOutputs();
               break;
          
           case SWITCH_PWM:
               //Default frequency is 1000Hz
-              switchEntry[switchID]->type = (enum SwitchType) newType;
-              switchEntry[switchID]->min = (float) MINVAL;
-              switchEntry[switchID]->max = (float) MAXDIGITALVAL; 
-              switchEntry[switchID]->step = 1.0F;
-              switchEntry[switchID]->value = switchEntry[switchID]->min;
+              switchEntry[switchID].type = (enum SwitchType) newType;
+              switchEntry[switchID].min = (float) MINVAL;
+              switchEntry[switchID].max = (float) MAXDIGITALVAL; 
+              switchEntry[switchID].step = 1.0F;
+              switchEntry[switchID].value = switchEntry[switchID].min;
+              onSwitchValueChanged( switchID );
+              markSwitchDirty( switchID );
+              refreshRelayOutputs();
               analogWriteRange ( 1024);
-              analogWrite( switchEntry[switchID]->pin, switchEntry[switchID]->value );              
+              analogWrite( switchEntry[switchID].pin, switchEntry[switchID].value );              
               returnCode = 200;
               break;
           case SWITCH_ANALG_DAC:                        
           default:
-              root["ErrorMessage"]= "Invalid switch type not found or implemented";
-              root["ErrorNumber"] = invalidValue ;
+              alpacaError( root, invalidValue, "Invalid switch type not found or implemented" );
               returnCode = 400;
               break;
           }
@@ -555,18 +546,15 @@ void handlerDriver0SwitchType(void)
       else
       {
          returnCode = 400;
-         root["ErrorMessage"]= "Invalid HTTP verb or arguments found";
-         root["ErrorNumber"] = invalidOperation ;
+         alpacaError( root, invalidOperation, "Invalid HTTP verb or arguments found" );
       }
     }
     else
     {
        returnCode = 400;
-       root["ErrorMessage"]= "Argument switchID out of range";
-       root["ErrorNumber"] = invalidValue ;
+       alpacaError( root, invalidValue, "Argument switchID out of range" );
     }
-    root.printTo(message);
-    server.send(returnCode, "application/json", message);
+    sendAlpacaResponse( returnCode, root );
     return;
 }
 
@@ -575,29 +563,24 @@ void handlerDriver0SwitchType(void)
 //Get/Set the value of the specified switch device as a double - ie not a binary setting
 void handlerDriver0SwitchValue(void)
 {
-    String message;
-    uint32_t clientID = (uint32_t)server.arg("ClientID").toInt();
-    uint32_t transID = (uint32_t)server.arg("ClientTransactionID").toInt();
+    uint32_t clientID = (uint32_t) requestArgs.getInt( ARG_CLIENT_ID );
+    uint32_t transID = (uint32_t) requestArgs.getInt( ARG_CLIENT_TRANS_ID );
     int returnCode = 200;
     float value = 0.0F;
     uint32_t switchID = 0;
-    String argToSearchFor[2] = {"Id", "Value"};
     
-    DynamicJsonBuffer jsonBuffer(256);
-    JsonObject& root = jsonBuffer.createObject();
-    jsonResponseBuilder( root, clientID, transID, serverTransID++, "SwitchValue", 0, "" );    
+    AlpacaResponse root;
+    alpacaResponseBuilder( root, clientID, transID, serverTransID++, "SwitchValue", 0, "" );    
     
-    if ( hasArgIC( argToSearchFor[0], server, false ) )
+    if ( requestArgs.has( ARG_ID ) )
     {
-      switchID = server.arg( argToSearchFor[0] ).toInt();
+      switchID = requestArgs.getInt( ARG_ID );
     }
     else
     {
-      root["ErrorMessage"] = "Missing argument - switchID ";
-      root["ErrorNumber"] = invalidValue ;
+      alpacaError( root, invalidValue, "Missing argument - switchID " );
       returnCode = 400;      
-      root.printTo(message);
-      server.send(returnCode, "application/json", message);
+      sendAlpacaResponse( returnCode, root );
       return;      
     }
       
@@ -605,123 +588,274 @@ void handlerDriver0SwitchValue(void)
     {
         if( server.method() == HTTP_GET )
         {
-          switch( switchEntry[switchID]->type )
+          switch( switchEntry[switchID].type )
           {
             case SWITCH_PWM: 
-                  root["Value"] = switchEntry[switchID]->value;
+                  alpacaValue( root, switchEntry[switchID].value );
                   break;
             case SWITCH_ANALG_DAC:
-                  root["Value"] = switchEntry[switchID]->value;
+                  alpacaValue( root, switchEntry[switchID].value );
                   returnCode = 200;
                   break;                
             case SWITCH_RELAY_NO:
             case SWITCH_RELAY_NC:
                   returnCode = 400;
-                  root["ErrorMessage"] = "Invalid analogue operation for binary/boolean switch type - use getSwitch";
-                  root["ErrorNumber"] = invalidOperation ;
+                  alpacaError( root, invalidOperation, "Invalid analogue operation for binary/boolean switch type - use getSwitch" );
                   break;
             default:
               break;           
           }
         }
-        else if( server.method() == HTTP_PUT && hasArgIC( argToSearchFor[1], server, false ) )
+        else if( server.method() == HTTP_PUT && requestArgs.has( ARG_VALUE ) )
+        {
+          value = (float) requestArgs.getFloat( ARG_VALUE );
+          returnCode = applySwitchValue( root, switchID, value );
+        }
+        else
+        {
+           returnCode = 400;
+           alpacaError( root, invalidOperation, "Invalid HTTP verb method for this URI or missing output value" );
+        }
+    }
+    else
+    {
+      alpacaError( root, invalidValue, "SwitchID value out of range." );
+      returnCode = 200;
+    }            
+    
+    sendAlpacaResponse( returnCode, root );
+    return;
+}
+
+//Non-ascom function
+//PUT /switch/{device_number}/setswitches
+//Set several switches in one request. Arguments are repeated Id/State or Id/Value pairs in order,
+//e.g. Id=0&State=true&Id=1&State=false&Id=4&Value=512
+//Every entry is validated before anything is changed - if any entry fails no switch is changed and the per-entry errors are returned.
+//Relay changes go into the shadow register and are flushed to the PCF8574 in a single write8 before replying.
+void handlerDriver0SetSwitches(void)
+{
+    uint32_t clientID = (uint32_t) requestArgs.getInt( ARG_CLIENT_ID );
+    uint32_t transID = (uint32_t) requestArgs.getInt( ARG_CLIENT_TRANS_ID );
+    int returnCode = 200;
+    int i = 0, j = 0;
+    int numEntries = 0;
+    bool allValid = true;
+    bool relayChanged = false;
+    struct
+    {
+      int id;
+      bool hasState;
+      bool hasValue;
+      bool state;
+      float value;
+      int errorNumber;
+      const char* errorMessage;
+    } entries[MAXSWITCH];
+
+    AlpacaResponse root;
+    alpacaResponseBuilder( root, clientID, transID, serverTransID++, "SetSwitches", Success, "" );
+
+    if( server.method() != HTTP_PUT )
+    {
+      alpacaError( root, invalidOperation, "Invalid HTTP verb method for this URI" );
+      sendAlpacaResponse( 400, root );
+      return;
+    }
+
+    //Collect the pairs in the order given - each Id starts a new entry.
+    for ( i = 0; i < requestArgs.count(); i++ )
+    {
+      uint32_t key = requestArgs.keyAt(i);
+      if( key == ARG_ID )
+      {
+        if ( numEntries >= MAXSWITCH )
+        {
+          allValid = false;
+          alpacaError( root, invalidValue, "Too many switch entries in request" );
+          break;
+        }
+        entries[numEntries].id = requestArgs.intAt(i);
+        entries[numEntries].hasState = false;
+        entries[numEntries].hasValue = false;
+        entries[numEntries].state = false;
+        entries[numEntries].value = 0.0F;
+        entries[numEntries].errorNumber = Success;
+        entries[numEntries].errorMessage = "";
+        numEntries++;
+      }
+      else if( key == ARG_STATE && numEntries > 0 )
+      {
+        entries[numEntries-1].hasState = true;
+        entries[numEntries-1].state = requestArgs.isTrueAt(i);
+      }
+      else if( key == ARG_VALUE && numEntries > 0 )
+      {
+        entries[numEntries-1].hasValue = true;
+        entries[numEntries-1].value = requestArgs.floatAt(i);
+      }
+    }
+
+    if ( numEntries == 0 && allValid )
+    {
+      allValid = false;
+      alpacaError( root, invalidOperation, "Missing argument: switchID" );
+    }
+
+    //Validate everything before touching the hardware
+    for ( i = 0; i < numEntries; i++ )
+    {
+      int id = entries[i].id;
+
+      if ( id < 0 || id >= numSwitches )
+      {
+        entries[i].errorNumber = invalidValue;
+        entries[i].errorMessage = "Invalid switch ID as argument";
+      }
+      else if ( !switchEntry[id].writeable )
+      {
+        entries[i].errorNumber = invalidOperation;
+        entries[i].errorMessage = "Switch is not writeable";
+      }
+      else
+      {
+        for ( j = 0; j < i; j++ )
+        {
+          if( entries[j].id == id )
+          {
+            entries[i].errorNumber = invalidValue;
+            entries[i].errorMessage = "Duplicate switch ID in request";
+          }
+        }
+        if ( entries[i].errorNumber == Success )
         {
-          value = (float) server.arg( argToSearchFor[1] ).toFloat();
-          switch( switchEntry[switchID]->type ) 
+          switch( switchEntry[id].type )
           {
-            case SWITCH_PWM: 
-                  if ( value >= switchEntry[switchID]->min && 
-                       value <= switchEntry[switchID]->max )
-                  {
-                    switchEntry[switchID]->value = value;
-                    analogWrite( switchEntry[switchID]->pin, switchEntry[switchID]->value );
-                    returnCode = 200;
-                  }
-                  else
-                  {
-                    root["ErrorMessage"] = "Digital write out of range for switch in PWM mode";
-                    root["ErrorNumber"] = invalidOperation ;
-                    returnCode = 200;
-                  }                  
-                  break;
-                  
             case SWITCH_RELAY_NO:
             case SWITCH_RELAY_NC:
-                  returnCode = 400;
-                  root["ErrorMessage"] = "Invalid analogue operation for binary/boolean switch type";
-                  root["ErrorNumber"] = invalidOperation ;
-                  break;
+              if ( !entries[i].hasState )
+              {
+                entries[i].errorNumber = invalidOperation;
+                entries[i].errorMessage = "Missing State for binary/boolean switch type";
+              }
+              break;
+            case SWITCH_PWM:
+              if ( !entries[i].hasValue )
+              {
+                entries[i].errorNumber = invalidOperation;
+                entries[i].errorMessage = "Missing Value for switch in PWM mode";
+              }
+              else if ( entries[i].value < switchEntry[id].min || entries[i].value > switchEntry[id].max )
+              {
+                entries[i].errorNumber = invalidValue;
+                entries[i].errorMessage = "Digital write out of range for switch in PWM mode";
+              }
+              break;
             case SWITCH_ANALG_DAC:
-                  if ( value >= switchEntry[switchID]->min && 
-                       value <= switchEntry[switchID]->max )
-                  {
-                    switchEntry[switchID]->value = value;
-                    //e.g. analogue_write( switchEntry[switchID]->value, switchEntry[switchID]->pin );
-                    root["ErrorMessage"] = "DAC Not implemented yet - Invalid digital operation for switch";
-                    root["ErrorNumber"] = invalidOperation ;
-                  }
-                  returnCode = 200;
-                  break;
             default:
+              entries[i].errorNumber = notImplemented;
+              entries[i].errorMessage = "DAC Not implemented yet - Invalid digital operation for switch";
               break;
           }
         }
-        else
+      }
+      if ( entries[i].errorNumber != Success )
+        allValid = false;
+    }
+
+    //Apply - all relays in one bus write.
+    if ( allValid )
+    {
+      for ( i = 0; i < numEntries; i++ )
+      {
+        int id = entries[i].id;
+        switch( switchEntry[id].type )
         {
-           returnCode = 400;
-           root["ErrorMessage"] = "Invalid HTTP verb method for this URI or missing output value";
-           root["ErrorNumber"] = invalidOperation ;
+          case SWITCH_RELAY_NO:
+          case SWITCH_RELAY_NC:
+            setRelayState( id, entries[i].state );
+            relayChanged = true;
+            break;
+          case SWITCH_PWM:
+            switchEntry[id].value = entries[i].value;
+            onSwitchValueChanged( id );
+            analogWrite( switchEntry[id].pin, switchEntry[id].value );
+            break;
+          default:
+            break;
         }
+      }
+
+      if ( relayChanged )
+      {
+        if ( !flushRelays() )
+        {
+          alpacaError( root, invalidOperation, "Relay bus write failed" );
+          returnCode = 500;
+        }
+      }
     }
     else
     {
-      root["ErrorMessage"] = "SwitchID value out of range.";
-      root["ErrorNumber"] = invalidValue ;
-      returnCode = 200;
-    }            
-    
-    root.printTo(message);
-    server.send(returnCode, F("application/json"), message);
+      if ( numEntries > 0 )
+      {
+        alpacaError( root, invalidValue, "One or more entries invalid - no switches changed" );
+      }
+      returnCode = 400;
+    }
+
+    //Per-entry results can outgrow the response buffer so stream them out in chunks
+    JsonWriter writer( responseBuffer, sizeof( responseBuffer ), sendChunk );
+    beginChunkedJson( returnCode );
+    writer.beginObject();
+    alpacaWriteHeader( writer, root );
+    writer.beginArray( "Value" );
+    for ( i = 0; i < numEntries; i++ )
+    {
+      writer.beginObject();
+      writer.add( "Id", entries[i].id );
+      writer.add( "ErrorNumber", entries[i].errorNumber );
+      writer.add( "ErrorMessage", entries[i].errorMessage );
+      writer.endObject();
+    }
+    writer.endArray();
+    writer.endObject();
+    writer.flush();
+    endChunked();
     return;
 }
-  
+
 //GET ​/switch​/{device_number}​/minswitchvalue
 //Gets the minimum value of the specified switch device as a double
 void handlerDriver0MinSwitchValue(void)
 {
-    String message;
-    uint32_t clientID = (uint32_t)server.arg("ClientID").toInt();
-    uint32_t transID = (uint32_t)server.arg("ClientTransactionID").toInt();
+    uint32_t clientID = (uint32_t) requestArgs.getInt( ARG_CLIENT_ID );
+    uint32_t transID = (uint32_t) requestArgs.getInt( ARG_CLIENT_TRANS_ID );
     int returnCode = 200;
     int switchID  = -1;
-    String argToSearchFor = "id";
     
-    DynamicJsonBuffer jsonBuffer(256);
-    JsonObject& root = jsonBuffer.createObject();
-    jsonResponseBuilder( root, clientID, transID, serverTransID++, "MinSwitchValue", Success, "" );    
+    AlpacaResponse root;
+    alpacaResponseBuilder( root, clientID, transID, serverTransID++, "MinSwitchValue", Success, "" );    
     
-    if ( hasArgIC( argToSearchFor, server, false  ) )
+    if ( requestArgs.has( ARG_ID ) )
     {
-      switchID = server.arg( argToSearchFor ).toInt();
+      switchID = requestArgs.getInt( ARG_ID );
       if( switchID >= 0 && switchID < numSwitches )
       {  
-        root.set<double>("Value", switchEntry[switchID]->min );
+        alpacaValue( root, (double) switchEntry[switchID].min );
       }
       else
       {
-        root["ErrorMessage"] = "SwitchID value out of range.";
-        root["ErrorNumber"] = invalidValue ;
+        alpacaError( root, invalidValue, "SwitchID value out of range." );
         returnCode = 400;        
       }
     }
     else
     {
-      root["ErrorMessage"] = "SwitchID argument missing .";
-      root["ErrorNumber"] = invalidOperation ;
+      alpacaError( root, invalidOperation, "SwitchID argument missing ." );
       returnCode = 400;
     }
-    root.printTo(message);
-    server.send(returnCode, F("application/json"), message);
+    sendAlpacaResponse( returnCode, root );
     return;
 }
 
@@ -729,40 +863,34 @@ void handlerDriver0MinSwitchValue(void)
 //Gets the maximum value of the specified switch device as a double
 void handlerDriver0MaxSwitchValue(void)
 {
-    String message;
-    uint32_t clientID = (uint32_t)server.arg("ClientID").toInt();
-    uint32_t transID = (uint32_t)server.arg("ClientTransactionID").toInt();
+    uint32_t clientID = (uint32_t) requestArgs.getInt( ARG_CLIENT_ID );
+    uint32_t transID = (uint32_t) requestArgs.getInt( ARG_CLIENT_TRANS_ID );
     int returnCode = 200;
     int switchID  = -1;
-    String argToSearchFor = "Id";
     
-    DynamicJsonBuffer jsonBuffer(256);
-    JsonObject& root = jsonBuffer.createObject();
-    jsonResponseBuilder( root, clientID, transID, serverTransID++, "MaxSwitchValue", Success, "" );    
+    AlpacaResponse root;
+    alpacaResponseBuilder( root, clientID, transID, serverTransID++, "MaxSwitchValue", Success, "" );    
 
-    if ( hasArgIC(argToSearchFor, server, false ) )
+    if ( requestArgs.has( ARG_ID ) )
     {
-      switchID = server.arg(argToSearchFor).toInt();
+      switchID = requestArgs.getInt( ARG_ID );
       if ( switchID >= 0 && switchID < numSwitches )
       {
-        root.set<double>("Value", switchEntry[switchID]->max );
+        alpacaValue( root, (double) switchEntry[switchID].max );
         returnCode = 200;
       }
       else
       {
-        root["ErrorMessage"] = "SwitchID value out of range.";
-        root["ErrorNumber"] = invalidValue ;
+        alpacaError( root, invalidValue, "SwitchID value out of range." );
         returnCode = 400;              
       }
     }
     else
     {
-       root["ErrorMessage"] = "Missing switchID argument.";
-       root["ErrorNumber"] = invalidOperation  ;
+       alpacaError( root, invalidOperation, "Missing switchID argument." );
        returnCode = 400;
     }
-    root.printTo(message);
-    server.send(returnCode, F("application/json"), message);
+    sendAlpacaResponse( returnCode, root );
     return;
 }
 
@@ -770,40 +898,34 @@ void handlerDriver0MaxSwitchValue(void)
 //Returns the step size that this device supports (the difference between successive values of the device).
 void handlerDriver0SwitchStep(void)
 {
-    String message;
-    uint32_t clientID = (uint32_t)server.arg("ClientID").toInt();
-    uint32_t transID = (uint32_t)server.arg("ClientTransactionID").toInt();
+    uint32_t clientID = (uint32_t) requestArgs.getInt( ARG_CLIENT_ID );
+    uint32_t transID = (uint32_t) requestArgs.getInt( ARG_CLIENT_TRANS_ID );
     uint32_t switchID = -1;
     int returnCode = 200;
-    String argToSearchFor = "Id";
     
-    DynamicJsonBuffer jsonBuffer(256);
-    JsonObject& root = jsonBuffer.createObject();
-    jsonResponseBuilder( root, clientID, transID, serverTransID++, "SwitchStep", Success, "" );    
+    AlpacaResponse root;
+    alpacaResponseBuilder( root, clientID, transID, serverTransID++, "SwitchStep", Success, "" );    
 
-    if ( hasArgIC(argToSearchFor, server, false ) )
+    if ( requestArgs.has( ARG_ID ) )
     {
-      switchID = server.arg(argToSearchFor).toInt();
+      switchID = requestArgs.getInt( ARG_ID );
       if( switchID >= 0 && switchID < (uint32_t) numSwitches ) 
       {
-        root.set<double>("Value", switchEntry[switchID]->step );        
+        alpacaValue( root, (double) switchEntry[switchID].step );        
         returnCode = 200;
       }
       else
       {
-         root["ErrorMessage"] = "SwitchID out of range.";
-         root["ErrorNumber"] = invalidValue ;
+         alpacaError( root, invalidValue, "SwitchID out of range." );
          returnCode = 400;
       }
     }
     else
     {
-       root["ErrorMessage"] = "Missing switchID argument.";
-       root["ErrorNumber"] = invalidOperation ;
+       alpacaError( root, invalidOperation, "Missing switchID argument." );
        returnCode = 400;    
     }
-    root.printTo(message);
-    server.send(returnCode, F("application/json"), message);
+    sendAlpacaResponse( returnCode, root );
     return;
 }
 
@@ -812,16 +934,13 @@ void handlerDriver0SwitchStep(void)
 
 void handlerNotFound()
 {
-  String message;
   int responseCode = 400;
-  uint32_t clientID = (uint32_t)server.arg("ClientID").toInt();
-  uint32_t transID = (uint32_t)server.arg("ClientTransactionID").toInt();
-  DynamicJsonBuffer jsonBuffer(250);
-  JsonObject& root = jsonBuffer.createObject();
-  jsonResponseBuilder( root, clientID, transID, serverTransID++, "HandlerNotFound", invalidOperation , "No REST handler found for argument - check ASCOM Switch v2 specification" );    
-  root["Value"] = 0;
-  root.printTo(message);
-  server.send(responseCode, F("application/json"), message);
+  uint32_t clientID = (uint32_t) requestArgs.getInt( ARG_CLIENT_ID );
+  uint32_t transID = (uint32_t) requestArgs.getInt( ARG_CLIENT_TRANS_ID );
+  AlpacaResponse root;
+  alpacaResponseBuilder( root, clientID, transID, serverTransID++, "HandlerNotFound", invalidOperation , "No REST handler found for argument - check ASCOM Switch v2 specification" );    
+  alpacaValue( root, 0 );
+  sendAlpacaResponse( responseCode, root );
 }
 
 void handlerRestart()
@@ -831,120 +950,138 @@ void handlerRestart()
   server.sendHeader( WiFi.hostname().c_str(), String("/status"), true);
   server.send ( 302, F("text/html"), "<!Doctype html><html>Redirecting for restart</html>");
   DEBUGSL1(F("Reboot requested") );
+  saveToEeprom();
   device.restart();
  }
 
+//Non-ASCOM 
+//GET|PUT /setup/flush
+//Commit any setup changes still waiting for the write-behind delay
+void handlerDeviceFlush(void)
+{
+  bool saved = false;
+  JsonWriter writer( responseBuffer, sizeof( responseBuffer ) );
+
+  saveToEeprom();
+  saved = ( eepromDirty == 0 );
+
+  writer.beginObject();
+  writer.add( "saved", saved );
+  writer.add( "pending", (unsigned long) eepromDirty );
+  writer.endObject();
+  sendJson( ( saved ) ? 200 : 500, writer.c_str(), writer.length() );
+}
+
 void handlerNotImplemented()
 {
-  String message;
   int responseCode = 400;
-  uint32_t clientID = (uint32_t)server.arg("ClientID").toInt();
-  uint32_t transID = (uint32_t)server.arg("ClientTransactionID").toInt();
-
-  DynamicJsonBuffer jsonBuffer(250);
-  JsonObject& root = jsonBuffer.createObject();
-  jsonResponseBuilder( root, clientID, transID, serverTransID++, "HandlerNotFound", notImplemented  , "No REST handler implemented for argument - check ASCOM Dome v2 specification" );    
-  root["Value"] = 0;
-  root.printTo(message);
-  server.send(responseCode, F("application/json"), message);
+  uint32_t clientID = (uint32_t) requestArgs.getInt( ARG_CLIENT_ID );
+  uint32_t transID = (uint32_t) requestArgs.getInt( ARG_CLIENT_TRANS_ID );
+
+  AlpacaResponse root;
+  alpacaResponseBuilder( root, clientID, transID, serverTransID++, "HandlerNotFound", notImplemented  , "No REST handler implemented for argument - check ASCOM Dome v2 specification" );    
+  alpacaValue( root, 0 );
+  sendAlpacaResponse( responseCode, root );
 }
 
-//GET ​/switch​/{device_number}​/status
-//Get a descriptor of all the switches managed by this driver for discovery purposes
-void handlerStatus(void)
+/*
+ * The setup page is a static gzipped asset in flash (Webrelay_setuppage.h, built from setup/setup.html by
+ * setup/make_setup_page.py) that the browser caches, so a page view costs the device nothing but the send.
+ * The page reads the settings from /setup/config and posts its forms back to the handlers below, which reply with
+ * {"status":<code>,"error":"<message>"}. Every browser in use sends Accept-Encoding: gzip so there is no plain copy.
+ */
+void sendSetupPage( void )
 {
-    String message, timeString;
-    uint32_t clientID = 0;//(uint32_t)server.arg("ClientID").toInt();
-    uint32_t transID = 0;//(uint32_t)server.arg("ClientTransactionID").toInt();
-    int i=0;
-    int returnCode = 200;
-    
-    DynamicJsonBuffer jsonBuffer(1024); //Uplifted in size = 256 + numSwitches * ( sizeof ( switchentry ) + 3* MAX_NAME_LENGTH )
-    JsonObject& root = jsonBuffer.createObject();
-    JsonArray& entries = root.createNestedArray( "switches" );
-    jsonResponseBuilder( root, clientID, transID, serverTransID++, "Status", 0, "" );    
-    
-    root["time"] = getTimeAsString( timeString );
-    root["host"] = myHostname;
-    root["build version"]         = String(__DATE__) + FPSTR(BuildVersionName);
-    root["connected"] = ( connected != NOT_CONNECTED )?"true":"false";
-    root["connectedId"] = (int) connected;
-    
-    for( i = 0; i < numSwitches; i++ )
+    server.sendHeader( F("ETag"), F(SETUP_PAGE_ETAG) );
+    if ( server.header( "If-None-Match" ) == SETUP_PAGE_ETAG )
     {
-      //Can I re-use a single object or do I need to create a new one each time? A: new one each time. 
-      JsonObject& entry = jsonBuffer.createObject();
-
-      entry["description"] = switchEntry[i]->description;
-      entry["name"]        = switchEntry[i]->switchName;
-      entry["type"]        = (int) switchEntry[i]->type;      
-      entry["pin"]         = (int) switchEntry[i]->pin;      
-      entry.set("writeable", switchEntry[i]->writeable );
-      entry["min"]         = switchEntry[i]->min;
-      entry["max"]         = switchEntry[i]->max;
-      entry["step"]        = switchEntry[i]->step;
-      if( switchEntry[i]->type == SWITCH_RELAY_NO || switchEntry[i]->type == SWITCH_RELAY_NC )
-      {
-        entry["state"]     = (switchEntry[i]->value == 1.0F ) ? true : false ;
-      }
-      else 
-        entry["value"]     = switchEntry[i]->value; //Needs check limits to 1-1024, DAC and PWM limits. 
-      entries.add( entry );
+      server.send( 304, F("text/html"), "" );
+      return;
     }
-    
-    //Do something here about outputting the ADC records too
-#if defined USE_ADC
-      JsonArray& voltages = root.createNestedArray( "voltages" );
-      for( i = 0; i < lastChannel; i++ )
-      {
-        JsonObject& entry = jsonBuffer.createObject();
-        entry["adcReading"] = (float) adcReading[i];
-        entry["adcScale"]   = (float) adcScaleFactor[i];
-        entry["adcGain"]    = (float) adcGainFactor[ adcGainSettings[i] ];
-        switch (i) 
-        {
-          case 0: entry["12v Voltage"] = (float) ( adcReading[i] * adcGainFactor[adcGainSettings[i]] * adcScaleFactor[i] ) ;
-            break;
-          case 1: entry["5v Voltage"] =  (float) ( adcReading[i] * adcGainFactor[adcGainSettings[i]] * adcScaleFactor[i] );
-            break;
-          case 2: entry["3v3 Voltage"] = (float) ( adcReading[i] * adcGainFactor[adcGainSettings[i]] * adcScaleFactor[i] );
-            break;
-          case 3: entry["Raw Voltage"] = (float) ( adcReading[i] * adcGainFactor[adcGainSettings[i]] * adcScaleFactor[i] ); 
-            break;
-          default:
-            break;
-        }
-        voltages.add( entry );
-      }
-
-#endif 
-    Serial.println( message);
-    
-    root.printTo(message);
-    server.send(returnCode, F("application/json"), message);
-    return;
+    server.sendHeader( F("Content-Encoding"), F("gzip") );
+    server.sendHeader( F("Cache-Control"), F("max-age=604800") );
+    server.send_P( 200, PSTR("text/html"), (PGM_P) setupPage, SETUP_PAGE_LENGTH );
 }
 
 //Helper function
-void sendDeviceSetup( int returnCode, String& message, String& err )
- {
-    //Send large pages in chunks
-    server.setContentLength(CONTENT_LENGTH_UNKNOWN);
-    setupFormBuilderHeader( message );      
-    server.send( returnCode, F("text/html"), message );
-    message = "";
-
-    setupFormBuilderDeviceHeader( message, err );      
-    server.sendContent( message );
-    message = "";
-    
-    setupFormBuilderDeviceStrings( message );      
-    server.sendContent( message );
-    message = "";    
-    
-    setupFormBuilderFooter( message );
-    server.sendContent( message );
- }
+void sendSetupResult( int returnCode, const String& err )
+{
+    JsonWriter writer( responseBuffer, sizeof( responseBuffer ) );
+
+    //Some of the switch checks set 0x400 style codes - send those as a plain bad request
+    if ( returnCode < 100 || returnCode > 599 )
+      returnCode = 400;
+    writer.beginObject();
+    writer.add( "status", returnCode );
+    writer.add( "error", err.c_str() );
+    writer.endObject();
+    sendJson( returnCode, writer.c_str(), writer.length() );
+}
+
+//Non-ASCOM 
+//GET /setup/config
+//The settings shown on the setup page - streamed since the switch list can outgrow the response buffer
+void handlerSetupConfig( void )
+{
+    int i = 0;
+    JsonWriter writer( responseBuffer, sizeof( responseBuffer ), sendChunk );
+
+    if ( sendNotModified() )
+      return;
+    beginChunkedJson( 200 );
+    writer.beginObject();
+    writer.add( "hostname", myHostname );
+    writer.add( "location", Location );
+    writer.add( "udpPort", udpPort );
+#if defined USE_ASYNC_SERVER
+    writer.add( "updatePort", UPDATE_SERVER_PORT );
+#else
+    writer.add( "updatePort", ALPACA_HTTP_PORT );
+#endif
+    writer.add( "numSwitches", numSwitches );
+    writer.add( "maxSwitch", MAXSWITCH );
+    writer.add( "maxNameLength", MAX_NAME_LENGTH );
+
+    writer.beginObject( "limits" );
+    writer.add( "minVal", (double) MINVAL );
+    writer.add( "maxBinaryVal", (double) MAXBINARYVAL );
+    writer.add( "maxDigitalVal", (double) MAXDIGITALVAL );
+    writer.add( "nullPin", NULLPIN );
+    writer.endObject();
+
+    writer.beginArray( "pins" );
+    for ( i = 0; pinMap[i] != NULLPIN; i++ )
+      writer.add( nullptr, pinMap[i] );
+    writer.endArray();
+
+    //Selectable types - not 'Not Selected'
+    writer.beginArray( "types" );
+    for ( i = 0; i < SWITCH_NOT_SELECTED; i++ )
+      writer.add( nullptr, switchTypes[i].c_str() );
+    writer.endArray();
+
+    writer.beginArray( "switches" );
+    for ( i = 0; i < numSwitches; i++ )
+    {
+      SwitchEntry& se = switchEntry[i];
+      writer.beginObject();
+      writer.add( "id", i );
+      writer.add( "name", se.switchName );
+      writer.add( "description", se.description );
+      writer.add( "type", (int) se.type );
+      writer.add( "writeable", se.writeable );
+      writer.add( "pin", (int) se.pin );
+      writer.add( "min", (double) se.min );
+      writer.add( "max", (double) se.max );
+      writer.add( "step", (double) se.step );
+      writer.add( "value", (double) se.value );
+      writer.endObject();
+    }
+    writer.endArray();
+    writer.endObject();
+    writer.flush();
+    endChunked();
+}
 
 /*
  * Handlers to do custom setup that can't be done without a windows ascom driver setup form. 
@@ -953,14 +1090,13 @@ void sendDeviceSetup( int returnCode, String& message, String& err )
  void handlerDeviceSetup( ) 
  {
    String timeString, message, err;
-    uint32_t clientID = (uint32_t)server.arg("ClientID").toInt();
-    uint32_t transID = (uint32_t)server.arg("ClientTransactionID").toInt();
+    uint32_t clientID = (uint32_t) requestArgs.getInt( ARG_CLIENT_ID );
+    uint32_t transID = (uint32_t) requestArgs.getInt( ARG_CLIENT_TRANS_ID );
     uint32_t switchID = -1;
     
-    int returnCode = 200;
     if ( server.method() == HTTP_GET )
     {
-        sendDeviceSetup( returnCode, message, err );
+        sendSetupPage();
     }
  }
 
@@ -971,24 +1107,24 @@ void sendDeviceSetup( int returnCode, String& message, String& err )
  void handlerDeviceHostname(void) 
  {
     String message, timeString, err= "";
-    uint32_t clientID = (uint32_t)server.arg("ClientID").toInt();
-    uint32_t transID = (uint32_t)server.arg("ClientTransactionID").toInt();
+    uint32_t clientID = (uint32_t) requestArgs.getInt( ARG_CLIENT_ID );
+    uint32_t transID = (uint32_t) requestArgs.getInt( ARG_CLIENT_TRANS_ID );
     uint32_t switchID = -1;
     
     int returnCode = 400;
-    String argToSearchFor[] = { "hostname" };
      
     if ( server.method() == HTTP_POST || server.method() == HTTP_PUT || server.method() == HTTP_GET)
     {
-        if( hasArgIC( argToSearchFor[0], server, false )  )
+        if( requestArgs.has( ARG_HOSTNAME )  )
         {
-          String newHostname = server.arg(argToSearchFor[0]) ;
+          String newHostname = requestArgs.value( ARG_HOSTNAME ) ;
           //process form variables.
           if( newHostname.length() > 0 && newHostname.length() < MAX_NAME_LENGTH-1 )
           {
             //process new hostname
             strncpy( myHostname, newHostname.c_str(), MAX_NAME_LENGTH );
-            saveToEeprom();
+            formatMqttTopics();
+            markConfigDirty();
             returnCode = 200;
           }
           else
@@ -1002,11 +1138,12 @@ void sendDeviceSetup( int returnCode, String& message, String& err )
       err = "Bad HTTP request verb";
     }
     
-    sendDeviceSetup( returnCode, message, err );    
+    sendSetupResult( returnCode, err );    
 
     if( returnCode == 200 ) 
     {              
       //Now reset to change the hostname and re-register DHCP
+      saveToEeprom();
       device.reset();
     }
  return;
@@ -1018,24 +1155,23 @@ void sendDeviceSetup( int returnCode, String& message, String& err )
  void handlerDeviceLocation(void) 
  {
     String message, timeString, err= "";
-    uint32_t clientID = (uint32_t)server.arg("ClientID").toInt();
-    uint32_t transID = (uint32_t)server.arg("ClientTransactionID").toInt();
+    uint32_t clientID = (uint32_t) requestArgs.getInt( ARG_CLIENT_ID );
+    uint32_t transID = (uint32_t) requestArgs.getInt( ARG_CLIENT_TRANS_ID );
     uint32_t switchID = -1;
     
     int returnCode = 400;
-    String argToSearchFor[] = { "location", };
      
     if ( server.method() == HTTP_POST || server.method() == HTTP_PUT || server.method() == HTTP_GET)
     {
-        if( hasArgIC( argToSearchFor[0], server, false )  )
+        if( requestArgs.has( ARG_LOCATION )  )
         {
-          String newLocation = server.arg(argToSearchFor[0]) ;
+          String newLocation = requestArgs.value( ARG_LOCATION ) ;
           //process form variables.
           if( newLocation.length() > 0 && newLocation.length() < MAX_NAME_LENGTH-1 )
           {
             //process new hostname
             strncpy( Location, newLocation.c_str(), MAX_NAME_LENGTH );
-            saveToEeprom();
+            markConfigDirty();
             returnCode = 200;    
           }
           else
@@ -1049,31 +1185,31 @@ void sendDeviceSetup( int returnCode, String& message, String& err )
       err = "Bad HTTP request verb";
     }
 
-    sendDeviceSetup( returnCode, message, err );
+    sendSetupResult( returnCode, err );
     return;    
  }
 
 void handlerDeviceUdpPort(void) 
  {
     String message, timeString, err = "";
-    uint32_t clientID = (uint32_t)server.arg("ClientID").toInt();
-    uint32_t transID = (uint32_t)server.arg("ClientTransactionID").toInt();
+    uint32_t clientID = (uint32_t) requestArgs.getInt( ARG_CLIENT_ID );
+    uint32_t transID = (uint32_t) requestArgs.getInt( ARG_CLIENT_TRANS_ID );
     uint32_t switchID = -1;    
    
     int returnCode = 400;
-    String argToSearchFor[] = { "discoveryport"};
      
     if ( server.method() == HTTP_POST || server.method() == HTTP_PUT || server.method() == HTTP_GET)
     {
-        if( hasArgIC( argToSearchFor[0], server, false )  )
+        if( requestArgs.has( ARG_DISCOVERY_PORT )  )
         {
-          int newPort = server.arg(argToSearchFor[0]).toInt() ;
+          int newPort = requestArgs.getInt( ARG_DISCOVERY_PORT ) ;
           //process form variables.
           if( newPort > 1024 && newPort < 65536  )
           {
-            //process new hostname
+            //Rebind the discovery responder to the new port
             udpPort = newPort;
-            saveToEeprom();
+            beginDiscovery();
+            markConfigDirty();
             returnCode = 200;
           }
           else
@@ -1089,36 +1225,9 @@ void handlerDeviceUdpPort(void)
       err = "Bad HTTP request verb";
     }
     
-    //Send large pages in chunks
-    sendDeviceSetup( returnCode, message, err );
+    sendSetupResult( returnCode, err );
  }
 
-//helper function
-void sendDriver0Setup( int returnCode, String& message, String& err )
-{
-  //Send large pages in chunks
-  server.setContentLength(CONTENT_LENGTH_UNKNOWN);
-  setupFormBuilderHeader( message );      
-  server.send( returnCode, "text/html", message );
-  message = "";
-  
-  setupFormBuilderDriverHeader( message, err );
-  server.sendContent( message );
-  message = "";
-  
-  //List the switches
-  for ( int i=0; i< numSwitches; i++ )
-  {
-    setupFormBuilderDriver0Switches( message, i ); 
-    server.sendContent( message );
-    message = "";
-  }
-
-  setupFormBuilderFooter( message );
-  server.sendContent( message );
-  message = "";
-}
-
 /*
  * Handlers to do custom setup that can't be done without a windows ascom driver setup form. 
  * Returns driver page for a specific Alpaca driver type, 
@@ -1127,14 +1236,13 @@ void sendDriver0Setup( int returnCode, String& message, String& err )
  void handlerDriver0Setup(void)
  {
    String message, timeString, err= "";
-    uint32_t clientID = (uint32_t)server.arg("ClientID").toInt();
-    uint32_t transID = (uint32_t)server.arg("ClientTransactionID").toInt();
+    uint32_t clientID = (uint32_t) requestArgs.getInt( ARG_CLIENT_ID );
+    uint32_t transID = (uint32_t) requestArgs.getInt( ARG_CLIENT_TRANS_ID );
     uint32_t switchID = -1;
     
-    int returnCode = 200;
     if ( server.method() == HTTP_GET )
     {
-        sendDriver0Setup( returnCode, message, err );
+        sendSetupPage();
     }
  }
 
@@ -1144,19 +1252,18 @@ void sendDriver0Setup( int returnCode, String& message, String& err )
  void handlerDriver0SetupNumSwitches(void) 
  {
     String message, timeString, err= "";
-    uint32_t clientID = (uint32_t)server.arg("ClientID").toInt();
-    uint32_t transID = (uint32_t)server.arg("ClientTransactionID").toInt();
+    uint32_t clientID = (uint32_t) requestArgs.getInt( ARG_CLIENT_ID );
+    uint32_t transID = (uint32_t) requestArgs.getInt( ARG_CLIENT_TRANS_ID );
     uint32_t switchID = -1;
     
     int returnCode = 400;
-    String argToSearchFor[] = { "numSwitches"};
      
     if ( server.method() == HTTP_POST || server.method() == HTTP_PUT || server.method() == HTTP_GET )
     {
-        if( hasArgIC( argToSearchFor[0], server, false )  )
+        if( requestArgs.has( ARG_NUM_SWITCHES )  )
         {
           //process form variables.
-          int newNumSwitches = server.arg(argToSearchFor[0]).toInt();
+          int newNumSwitches = requestArgs.getInt( ARG_NUM_SWITCHES );
           if( newNumSwitches == 0 || newNumSwitches > MAXSWITCH )
           {
             err = "Switch size exceeds device range or is zero.";
@@ -1164,9 +1271,10 @@ void sendDriver0Setup( int returnCode, String& message, String& err )
           else
           {
             //update the switches
-            switchEntry = reSize( switchEntry, newNumSwitches );            
+            reSize( newNumSwitches );
             numSwitches = newNumSwitches;
-            saveToEeprom();
+            refreshRelayOutputs();
+            markConfigDirty();
             returnCode = 200;              
           }
         }        
@@ -1176,7 +1284,7 @@ void sendDriver0Setup( int returnCode, String& message, String& err )
       err = "Bad HTTP request verb";
     }
 
-    sendDriver0Setup( returnCode, message, err );
+    sendSetupResult( returnCode, err );
     return;
  }
 
@@ -1187,19 +1295,21 @@ void sendDriver0Setup( int returnCode, String& message, String& err )
  void handlerDriver0SetupSwitches(void) 
  {
     String message, timeString, err= "";
-    uint32_t clientID = (uint32_t)server.arg("ClientID").toInt();
-    uint32_t transID = (uint32_t)server.arg("ClientTransactionID").toInt();
-    int i;
+    uint32_t clientID = (uint32_t) requestArgs.getInt( ARG_CLIENT_ID );
+    uint32_t transID = (uint32_t) requestArgs.getInt( ARG_CLIENT_TRANS_ID );
+    int i, j;
     int returnCode = 400;
-    String argToSearchFor[9] = { "switchId", "name", "description", "type", "writeable", "pin", "min", "max", "step" };
+    //Form fields are sent with the switch id appended, bar the first
+    static const uint32_t formFields[9] = { ARG_SWITCH_ID, ARG_FORM_NAME, ARG_FORM_DESCRIPTION, ARG_FORM_TYPE, ARG_FORM_WRITEABLE,
+                                            ARG_FORM_PIN, ARG_FORM_MIN, ARG_FORM_MAX, ARG_FORM_STEP };
+    int fieldPos[9];
     
     if ( server.method() == HTTP_POST || server.method() == HTTP_PUT || server.method() == HTTP_GET )
     {
       //Expecting an array of variables in form submission
       //Need to parse and handle
-      if( hasArgIC( argToSearchFor[0], server, false ) )
+      if( requestArgs.has( formFields[0] ) )
       {
-        String arg; 
         String name = "default_name", description="default_description";
         double min = 0.0, max=0.0, step=0.0;
         int pin = NULLPIN;
@@ -1207,22 +1317,37 @@ void sendDriver0Setup( int returnCode, String& message, String& err )
         bool  writeable = false;        
         bool allFound = true;
         int id = -1;
+        uint32_t formKeys[9];
         
         //Get the id of the current switch to be updated 
-        id = (int) server.arg( argToSearchFor[0] ).toInt();
+        id = (int) requestArgs.getInt( formFields[0] );
         debugV( "found switchId %d\n", id );
         
+        //Find where each field for this switch is in the arguments - one pass over them
+        for ( i=1; i < 9; i++ ) 
+        {
+          formKeys[i] = argKeyHashIndexed( formFields[i], id );
+          fieldPos[i] = -1;
+        }
+        for ( j=0; j < requestArgs.count(); j++ )
+        {
+          for ( i=1; i < 9; i++ )
+          {
+            if( fieldPos[i] < 0 && requestArgs.keyAt( j ) == formKeys[i] )
+            {
+              fieldPos[i] = j;
+              break;
+            }
+          }
+        }
+
         //Check for all args present 
-        int i=1;
         int foundCount = 0;
         for ( i=1; i < 9; i++ ) 
         {
-          arg = argToSearchFor[i] + id;
-          debugV( "arg sought: %s\n", arg.c_str() );
-
-          if( hasArgIC( arg, server, false )  )
+          if( fieldPos[i] >= 0 )
           {
-            debugV( "arg found: %s \n", arg.c_str() );
+            debugV( "arg found: %d \n", i );
             allFound |= true;
             foundCount ++;
             debugW( "foundCount %d \n", foundCount);            
@@ -1236,7 +1361,7 @@ void sendDriver0Setup( int returnCode, String& message, String& err )
         //4 is the number of variables expected for an analogue switch entry, 8 for a digital. 
         if( !allFound && foundCount == 4 ) 
         {
-          enum SwitchType localType = (enum SwitchType) server.arg( argToSearchFor[3] + id ).toInt();
+          enum SwitchType localType = (enum SwitchType) requestArgs.intAt( fieldPos[3] );
           debugV( "looking for type - found: %d\n", localType );
           
           if ( ( localType == SWITCH_RELAY_NC ) || ( localType == SWITCH_RELAY_NO ) )
@@ -1247,10 +1372,10 @@ void sendDriver0Setup( int returnCode, String& message, String& err )
             allFound = true;
             returnCode = 200;
             //Cache the existing values so they don't get overwritten with defaults. 
-            min = switchEntry[id]->min;
-            max = switchEntry[id]->max;
-            step = switchEntry[id]->step;
-            pin = switchEntry[id]->pin;
+            min = switchEntry[id].min;
+            max = switchEntry[id].max;
+            step = switchEntry[id].step;
+            pin = switchEntry[id].pin;
           }
           else
           {
@@ -1261,7 +1386,7 @@ void sendDriver0Setup( int returnCode, String& message, String& err )
         }
         else if ( !allFound && foundCount != 4 ) 
         {
-          debugW( "not all args found - failed at %d", i );
+          debugW( "not all args found - %d of 8", foundCount );
           err = "Not all form variables supplied";
           returnCode = 0x402; //check
         }
@@ -1276,10 +1401,9 @@ void sendDriver0Setup( int returnCode, String& message, String& err )
         //Switch name
         debugV( "%s\n", "all args found - checking values ");
 
-        arg = argToSearchFor[1] + id;
-        if( hasArgIC( arg, server, false ) && returnCode == 200 )
+        if( fieldPos[1] >= 0 && returnCode == 200 )
         {
-          name = server.arg( arg );
+          name = requestArgs.valueAt( fieldPos[1] );
           if ( name.length() >= MAX_NAME_LENGTH  ) 
           {
             err = "Name longer than max allowed ";//Should be prevented by form controls.
@@ -1291,10 +1415,9 @@ void sendDriver0Setup( int returnCode, String& message, String& err )
         }
           
         //Switch description        
-        arg = argToSearchFor[2] + id;
-        if( hasArgIC( arg, server, false ) && returnCode == 200 )
+        if( fieldPos[2] >= 0 && returnCode == 200 )
         {
-          description = server.arg( arg );
+          description = requestArgs.valueAt( fieldPos[2] );
           if ( description.length() >= MAX_NAME_LENGTH  ) 
           {
             err = "Description longer than max allowed ";//Should be prevented by form controls.
@@ -1306,48 +1429,43 @@ void sendDriver0Setup( int returnCode, String& message, String& err )
         }
   
         //Switch type
-        arg = argToSearchFor[3] + id;
-        if( hasArgIC( arg, server, false ) && returnCode == 200 )
+        if( fieldPos[3] >= 0 && returnCode == 200 )
         {
-          bool found = false;
           type = SWITCH_NOT_SELECTED;
 
-          int typeAsInt = server.arg( arg ).toInt();
+          int typeAsInt = requestArgs.intAt( fieldPos[3] );
           debugD( "switch type field found :%d\n", typeAsInt );
           
           if( typeAsInt >= 0 && typeAsInt < switchTypesLen )
           {
-              found = true;              
               type = (enum SwitchType) typeAsInt;
               debugV( "switch type field matched :%d\n", type );
           }
           else 
           {
-            debugW( "switch type field no valid value found (%d)\n", type );
+            debugW( "switch type field no valid value found (%d)\n", typeAsInt );
+            err = "Switch type out of range ";
             returnCode = 0x403;
-            ;//
           }
         }
         
         //Switch writeable
-        arg = argToSearchFor[4] + id;
         //If writeable is not checked, chrome doesn't send it as a form variable - hence its missing. 
         //So we have to assume its false if missing. 
         //Solved by replacing a checkbox with a pre-checked radio  
         writeable = false;
-        if( hasArgIC( arg, server, false ) && returnCode == 200 )
+        if( fieldPos[4] >= 0 && returnCode == 200 )
         {
-          writeable = (bool) server.arg( arg ).equalsIgnoreCase( "on" );
+          writeable = (bool) requestArgs.valueAt( fieldPos[4] ).equalsIgnoreCase( "on" );
           debugW( "%s", "handlerSwitchSetup - writeable value found:");DEBUGSL1( writeable );
         }
         
         if( foundCount > 4 && allFound ) 
         {
           //Switch pin
-          arg = argToSearchFor[5] + id;
-          if( hasArgIC( arg, server, false ) && returnCode == 200 )
+          if( fieldPos[5] >= 0 && returnCode == 200 )
           {
-            pin = (int) server.arg( arg ).toInt();
+            pin = (int) requestArgs.intAt( fieldPos[5] );
             if( type == SWITCH_PWM || type == SWITCH_ANALG_DAC )
             {
               //? in valid pin range ? 
@@ -1391,10 +1509,9 @@ void sendDriver0Setup( int returnCode, String& message, String& err )
           }
     
           //Switch min
-          arg = argToSearchFor[6] + id;
-          if( hasArgIC( arg, server, false ) && returnCode == 200  )
+          if( fieldPos[6] >= 0 && returnCode == 200  )
           {
-            min = server.arg( arg ).toFloat();            
+            min = requestArgs.floatAt( fieldPos[6] );            
             if( type == SWITCH_PWM || type == SWITCH_ANALG_DAC )
             {
               if ( ( min < MINVAL ) || ( min > MAXDIGITALVAL ) ) 
@@ -1416,10 +1533,9 @@ void sendDriver0Setup( int returnCode, String& message, String& err )
           }
     
           //Switch max - Should be prevented by form controls.
-          arg = argToSearchFor[7] + id;
-          if( hasArgIC( arg, server, false ) && returnCode == 200 )
+          if( fieldPos[7] >= 0 && returnCode == 200 )
           {
-            max = (float) server.arg( arg ).toFloat();
+            max = (float) requestArgs.floatAt( fieldPos[7] );
             if( type == SWITCH_PWM || type == SWITCH_ANALG_DAC )
             {
               if ( ( max < MINVAL ) || ( max > MAXDIGITALVAL ) ) 
@@ -1441,10 +1557,9 @@ void sendDriver0Setup( int returnCode, String& message, String& err )
           }
     
           //Switch step
-          arg = argToSearchFor[8] + id;
-          if( hasArgIC( arg, server, false ) && returnCode == 200 )
+          if( fieldPos[8] >= 0 && returnCode == 200 )
           {
-            step = (float) server.arg( arg ).toFloat();
+            step = (float) requestArgs.floatAt( fieldPos[8] );
             if( type == SWITCH_PWM || type == SWITCH_ANALG_DAC )
             {
               if ( step < MINVAL || step > MAXDIGITALVAL ) 
@@ -1484,33 +1599,38 @@ void sendDriver0Setup( int returnCode, String& message, String& err )
           else //Save the values found - they look OK otherwise
           {
             DEBUGSL1("handlerSwitchSetup - saving new values");
-            strcpy( switchEntry[id]->switchName, name.c_str() );
-            strcpy( switchEntry[id]->description, description.c_str() );
-            switchEntry[id]->max = max;
-            switchEntry[id]->min = min;
-            switchEntry[id]->step = step;
-            switchEntry[id]->pin = pin;
-            switchEntry[id]->writeable = writeable;
+            strcpy( switchEntry[id].switchName, name.c_str() );
+            strcpy( switchEntry[id].description, description.c_str() );
+            switchEntry[id].max = max;
+            switchEntry[id].min = min;
+            switchEntry[id].step = step;
+            switchEntry[id].pin = pin;
+            switchEntry[id].writeable = writeable;
             //Update current value to fall within new range 
-            switchEntry[id]->value = switchEntry[id]->min;
+            switchEntry[id].value = switchEntry[id].min;
+            onSwitchValueChanged( id );
             
             //Has the switch type changed for this switch ? 
-            if( switchEntry[id]->type != SWITCH_PWM && type == SWITCH_PWM ) 
+            if( switchEntry[id].type != SWITCH_PWM && type == SWITCH_PWM ) 
             {
-              switchEntry[id]->type = (enum SwitchType ) type; 
+              switchEntry[id].type = (enum SwitchType ) type; 
               analogWrite( pin, min );
             }
             //Are we re-setting the existing PWM mode pin
-            else if ( switchEntry[id]->type == SWITCH_PWM && type == SWITCH_PWM )
+            else if ( switchEntry[id].type == SWITCH_PWM && type == SWITCH_PWM )
             {
               analogWrite( pin, 0 );
             }
             //Or something else 
             else 
+            {
+              switchEntry[id].type = (enum SwitchType ) type;
               analogWrite( pin, 0 );
+            }
+            refreshRelayOutputs();
             
             //Save the new setup
-            saveToEeprom();
+            markSwitchDirty( id );
             returnCode = 200;
           }         
         }
@@ -1527,512 +1647,7 @@ void sendDriver0Setup( int returnCode, String& message, String& err )
       returnCode = 403; //check    
     }
 
-    sendDriver0Setup( returnCode, message, err );
+    sendSetupResult( returnCode, err );
     return;  
  }
-/*
- Handler for setup dialog - issue call to <hostname>/setup and receive a webpage
- Fill in the form and submit and handler for each form button will store the variables and return the same page.
- optimise to something like this:
- https://circuits4you.com/2018/02/04/esp8266-ajax-update-part-of-web-page-without-refreshing/
- Bear in mind HTML standard doesn't support use of PUT in forms and changes it to GET so arguments get sent in plain sight as 
- part of the URL.
- */
- /*   https://github.com/esp8266/Arduino/issues/3205
-  *   server.setContentLength(CONTENT_LENGTH_UNKNOWN);
-      server.send ( 200, "text/html", first_part.c_str());
-      while (...) 
-      {
-          resp = "...";
-          resp += "...";
-          server.sendContent(resp);
-      }
-  */
-
-String& setupFormBuilderHeader( String& htmlForm )
-{
-  String hostname = WiFi.hostname();
-
-  htmlForm = "<!DocType html><html lang=en ><head><meta charset=\"utf-8\">";
-  htmlForm += "<meta name=\"viewport\" content=\"width=device-width, initial-scale=1\">";
-  htmlForm += "<link rel=\"stylesheet\" href=\"https://maxcdn.bootstrapcdn.com/bootstrap/4.3.1/css/bootstrap.min.css\">";
-  htmlForm += "<script src=\"https://ajax.googleapis.com/ajax/libs/jquery/3.4.1/jquery.min.js\"></script>";
-  htmlForm += "<script src=\"https://cdnjs.cloudflare.com/ajax/libs/popper.js/1.14.7/umd/popper.min.js\"></script>";
-  htmlForm += "<script src=\"https://maxcdn.bootstrapcdn.com/bootstrap/4.3.1/js/bootstrap.min.js\"></script>";
-
-  htmlForm += "<style>\
-legend { font: 10pt;}\
-h1 { margin-top: 0; }\
-form { margin: 0 auto; width: 500px;padding: 1em;border: 1px solid #CCC;border-radius: 1em;}\
-div+div { margin-top: 1em; }\
-label span{display: inline-block;width: 150px;text-align: right;}\
-input, textarea {font: 1em sans-serif;width: 150px;box-sizing: border-box;border: 1px solid #999;}\
-input[type=checkbox], input[type=radio], input[type=submit]{width: auto;border: none;}\
-input:focus,textarea:focus{border-color:#000;}\
-textarea {vertical-align: top;height: 5em;resize: vertical;}\
-//fieldset {width: 410px;box-sizing: border-box;border: 1px solid #999;}\
-button {margin: 20px 0 0 124px;}\
-label {position:relative;}\
-label em { position: absolute;right: 5px;top: 20px;}\
-</style>";
-
-  //Used to enable/disable the input fields for binary relays vs digital PWM and DAC outputs. 
-  htmlForm += "<script>function setTypes( a ) { \
-  var searchFor = \"type\"+a;\
-  var x = document.getElementById(searchFor).value;\
-  if( x.indexOf( \"2\" ) >= 0 || x.indexOf( \"3\" ) >= 0 )\
-  {\
-      document.getElementById(\"pin\"+a).disabled = false;\
-        document.getElementById(\"pin\"+a).min=";
-  htmlForm += MINPIN;
-  htmlForm += "; document.getElementById(\"pin\"+a).max=";
-  htmlForm += MAXPIN;
-  htmlForm += "; document.getElementById(\"min\"+a).disabled=false;";
-  htmlForm += "document.getElementById(\"min\"+a).min=";
-  htmlForm += MINVAL;
-  htmlForm += "; document.getElementById(\"min\"+a).max=";
-  htmlForm += MAXDIGITALVAL;
-  htmlForm += "; document.getElementById(\"max\"+a).disabled=false;\
-        document.getElementById(\"max\"+a).min=";
-  htmlForm += MINVAL;
-  htmlForm += "; document.getElementById(\"max\"+a).max=";
-  htmlForm += MAXDIGITALVAL;
-  htmlForm += "; document.getElementById(\"step\"+a).disabled=false;\
-        document.getElementById(\"step\"+a).min=";
-  htmlForm += MINVAL;
-  htmlForm += "; document.getElementById(\"step\"+a).max = ";
-  htmlForm += MAXDIGITALVAL;
-  htmlForm += "}\n\
-  else\n\
-  {\
-      document.getElementById(\"pin\"+a).disabled = true;\      
-        document.getElementById(\"pin\"+a).value=";
-        htmlForm += NULLPIN;
-        htmlForm += "; ";
-        htmlForm += "document.getElementById(\"pin\"+a).min=0;\
-          document.getElementById(\"pin\"+a).max=";
-        htmlForm += NULLPIN;
-        htmlForm += "; ";
-      htmlForm +=" document.getElementById(\"min\"+a).disabled = true;\
-        document.getElementById(\"min\"+a).value=";
-        htmlForm += MINVAL;
-        htmlForm += "; ";
-        htmlForm += "document.getElementById(\"min\"+a).min=";
-        htmlForm += MINVAL;
-        htmlForm += "; ";
-        htmlForm += "document.getElementById(\"min\"+a).max=";
-        htmlForm += MAXBINARYVAL;
-        htmlForm += "; ";
-      htmlForm += "document.getElementById(\"max\"+a).disabled = true;\
-          document.getElementById(\"max\"+a).value=";  
-        htmlForm += MAXBINARYVAL;
-        htmlForm += "; ";
-        htmlForm += "document.getElementById(\"max\"+a).min=";
-        htmlForm += MINVAL;
-        htmlForm += "; ";
-        htmlForm += "document.getElementById(\"max\"+a).max=";
-        htmlForm += MAXBINARYVAL;
-        htmlForm += "; ";
-      htmlForm += "; document.getElementById(\"step\"+a).disabled = true;\  
-        document.getElementById(\"step\"+a).value = 0.0;\  
-        document.getElementById(\"step\"+a).min = 0.0;\  
-        document.getElementById(\"step\"+a).max = 1.0;\  
-  }\
-}</script>";
-  htmlForm += "</head>";
-  
-  return htmlForm;
-}
-
-String& setupFormBuilderDeviceHeader( String& htmlForm, String& errMsg )
-{
-  String hostname = WiFi.hostname();
-
-  htmlForm = F("<body><div class=\"container\">");
-  htmlForm += F("<div class=\"row\" id=\"topbar\" bgcolor='A02222'>");
-  htmlForm += F("<p> This is the setup page for the <a href=\"http://www.skybadger.net\">Skybadger</a> <a href=\"https://www.ascom-standards.org\">ASCOM</a> device '");
-  htmlForm += myHostname;
-  htmlForm += F("' device which implements the <a href=\"https://www.ascom-standards.org/api\">ALPACA</a> v1.0 API</b> for the devices listed below:");
-  htmlForm += F("<ul><li> <a href=\"/api/v1/switch/0/setup\"> ALPACA Switch 0</a> </li>");
-  htmlForm += F("<li> <end of drivers implemented>. </li>");
-  htmlForm += F("</ul></div>");
-
-  if( errMsg != NULL && errMsg.length() > 0 ) 
-  {
-    htmlForm += F("<div class=\"row\" id=\"errorbar\" bgcolor='lightred'>");
-    htmlForm += F("<b>Error Message</b>");
-    htmlForm += F("</div><hr>");
-  }
- 
-  return htmlForm;
-}
-
-String& setupFormBuilderDeviceStrings( String& htmlForm )
-{
-  String hostname = WiFi.hostname();
- 
-  //UDP Discovery port 
-  htmlForm  = F( "<div class=\"row float-left\" id=\"topbar-device\" bgcolor='A02222'> ");
-  htmlForm += F("<div class=\"col-sm-12\">" );
-  htmlForm += F("<p> This device supports the <a href=\"placeholder\">ALPACA UDP discovery API</a> on port: ");
-  htmlForm += udpPort;
-  htmlForm += F("</p></div></div>");
-  
-  //Device settings hostname 
-  htmlForm += F("<div class=\"row float-left\">");
-  htmlForm += F("<div class=\"col-sm-12\"><h2> Enter new hostname for device</h2><br/>");
-  htmlForm += F("<p>Changing the hostname will cause the device to reboot and may change the IP address!</p>");
-  htmlForm += F("<form method=\"POST\" id=\"hostname\" action=\"http://");
-  htmlForm.concat( myHostname );
-  htmlForm += F("/setup/hostname\">");
-  htmlForm += F("<input type=\"text\" name=\"hostname\" maxlength=\"");
-  htmlForm += String(MAX_NAME_LENGTH).c_str( );
-  htmlForm += F("\" value=\"");
-  htmlForm.concat( myHostname );
-  htmlForm += F("\"/>");
-  htmlForm += F("<label for=\"hostname\" > Hostname </label>");
-  htmlForm += F("<input type=\"submit\" value=\"Set hostname\" />");
-  htmlForm += F("</form></div></div>");
-
-  //Device settings location
-  htmlForm += "<div class=\"row float-left\">";
-  htmlForm += "<div class=\"col-sm-12\"><h2> Enter location to be reported by Management API for device</h2><br/>";
-  htmlForm += "<form method=\"POST\" id=\"location\" action=\"http://";
-  htmlForm.concat( myHostname );
-  htmlForm += "/setup/location\">";
-  htmlForm += "<input type=\"text\" name=\"location\" maxlength=\"";
-  htmlForm += String(MAX_NAME_LENGTH).c_str( );
-  htmlForm += "\" value=\"";
-  htmlForm.concat( Location );
-  htmlForm += "\"/>";
-  htmlForm += "<label for=\"location\" > Location </label>";
-  htmlForm += "<input type=\"submit\" value=\"Set location\" />";
-  htmlForm += "</form></div></div>";  
-
- //UDP Port
-  htmlForm += "<div class=\"row float-left\" id=\"discovery-port\" >";
-  htmlForm += "<div class=\"col-sm-12\"><h2> Enter new Discovery port number for device</h2>";
-  htmlForm += "<form method=\"POST\" action=\"http://";
-  htmlForm.concat( myHostname );
-  htmlForm += "/setup/udpport\">";
-  htmlForm += "<label for=\"udpport\" id=\"udpport\"> Port number to use for Management API discovery </label>";
-  htmlForm += "<input type=\"number\" name=\"udpport\" min=\"1024\" max=\"65535\" ";
-  htmlForm += "value=\"";
-  htmlForm.concat( udpPort );
-  htmlForm += "\"/>";
-  htmlForm += "<input type=\"submit\" value=\"Set port\" />";
-  htmlForm += "</form></div></div>"; 
-
- return htmlForm;
-}
-
-String& setupFormBuilderDriverHeader( String& htmlForm, String& errMsg )
-{
-  String hostname = WiFi.hostname();
-  
-  debugI("%s", "called driver0 header ");
-  htmlForm  = F("<body> <div class=\"container-fluid\">");
-  htmlForm += F("<div class=\"row float-left\" id=\"topbar\" bgcolor=\"A02222\">");
-  htmlForm += F("<div class=\"col-sm-12\">");
-  htmlForm += F("<p> This is the driver setup page for the <a href=\"http://www.skybadger.net\">Skybadger</a> <a href=\"https://www.ascom-standards.org\">ASCOM</a> Switch device ");
-  htmlForm += myHostname;
-  htmlForm += F(" which uses the <a href=\"https://www.ascom-standards.org/api\">ALPACA</a> v1.0 API</b> for Switches");
-  htmlForm += F("<p> Click <a href=\"/setup\"> Device Management <a/> to manage the device.  </p>");
-  htmlForm += F("</div></div>");
-
-  if( errMsg != NULL && errMsg.length() > 0 ) 
-  {
-    htmlForm += F("<div class=\"row\" id=\"errorbar\" bgcolor='lightred'><div class=col-sm-12>");
-    htmlForm += F("<div class=\"col-sm-12\"><b>");
-    htmlForm.concat ( errMsg );
-    htmlForm += F("</b></div></div><hr>");
-  }
-  
-  //Setup the number of switches - should be in a separate function but lumped in here.. Separate out when have multiple drivers for this device
-  htmlForm += "<div class=\"row float-left\"> ";
-  htmlForm += "<div class=\"col-sm-12\"><h2>Configure switches</h2><br/>";
-  htmlForm += "<p>Editing this to add switch components ('upscaling') will copy the existing setup to the new setup but you will need to edit the added switches. </p>";
-  htmlForm += "<p>Editing this to reduce the number of switch components ('downscaling') will delete the configuration for the switches dropped but retain those lower number switch configurations for further editing</p><br>";
-  htmlForm += "</div></div>";
-
-  htmlForm += "<div class=\"row\" id=\"numSwitches\">";
-  htmlForm += "<div class=\"col-sm-12\">";
-  htmlForm += "<form action=\"/api/v1/switch/0/numswitches\" method=\"POST\" id=\"switchcount\" >";
-  htmlForm += "<label for=\"numSwitches\" >Number of switch components</label>";
-  htmlForm += "<input type=\"number\" name=\"numSwitches\" min=\"1\" max=\"";
-  htmlForm += String( MAXSWITCH ).c_str();
-  htmlForm += "\" value=\"";
-  htmlForm += numSwitches;
-  htmlForm += "\">";
-  htmlForm += "<input type=\"submit\" value=\"Update\"> </form> </div></div>";
- 
-  htmlForm += "<div class=\"row float-left\">";
-  htmlForm += "<div class=\"col-sm-12\" id=\"switchConfig\"> <h2>Switch configuration </h2>";
-  htmlForm += "<br><p>To configure the switch types and limits, select the switch you need below.</p></div></div>";
-  return htmlForm;
-}
-
-String& setupFormBuilderDriver0Switches( String& htmlForm, int index )
-{
-  String hostname = WiFi.hostname();
-
-  htmlForm  = F("<div class=\"row float-left\" id=\"switch" );
-  htmlForm += index;
-  htmlForm += F("\"><div class=\"col-sm-6\">" );
-  htmlForm += F("<form action=\"/api/v1/switch/0/switches\" Method=\"PUT\">" );
-  htmlForm += F("<fieldset class=\"border p2\">");
-  htmlForm += F("<input type=\"hidden\" value=\"");
-  htmlForm += index;
-  htmlForm += F("\" name=\"switchId\" />");
-
-  htmlForm += F("<legend class=\"w-auto\">Settings Switch ");
-  htmlForm += index;
-  htmlForm += F("</legend>");
-
-  //Name
-  htmlForm += F("<label for=\"name");
-  htmlForm += index;
-  htmlForm += F("\"><span>Switch Name</span></label>");
-  htmlForm += F("<input type=\"text\" id=\"fname");
-  htmlForm += index;
-  htmlForm += F("\" name=\"name");
-  htmlForm += index;
-  htmlForm += F("\" value=\"");
-  htmlForm += switchEntry[index]->switchName;
-  htmlForm += F("\" maxlength=\"");
-  htmlForm += String(MAX_NAME_LENGTH).c_str( );
-  htmlForm += F("\"><br>");
-     
-  //Description
-  htmlForm += "<label for=\"description";
-  htmlForm += index;
-  htmlForm += "\"><span>Description</span></label>";
-  htmlForm += "<input type=\"text\" id=\"lname";
-  htmlForm += index;
-  htmlForm += "\" name=\"description";
-  htmlForm += index;
-  htmlForm += "\" value=\"";
-  htmlForm += switchEntry[index]->description;
-  htmlForm += "\" maxlength=\"";
-  htmlForm += String(MAX_NAME_LENGTH).c_str( );
-  htmlForm += "\"><br>";
-  
-  //Type - Hardware implementation detail exposed for configuration
-  htmlForm += "<label for=\"type";
-  htmlForm += index;
-  htmlForm += "\"><span>Switch type</span></label>";
-  htmlForm += "<select id=\"type";
-  htmlForm += index;
-  htmlForm += "\" name=\"type";
-  htmlForm += index;
-  htmlForm += "\" onChange=\"setTypes( ";
-  htmlForm += index;
-  htmlForm += " )\">";
-  for( int k=0; k < 4; k++ ) 
-  {
-    htmlForm += "<option value=\"";
-    htmlForm += k;
-    htmlForm += "\" ";
-    if ( ( (int) switchEntry[index]->type ) == k )
-      htmlForm += " selected ";
-    htmlForm += ">";
-    htmlForm += switchTypes[k].c_str();
-    htmlForm += "</option>";
-  }
-  htmlForm += "</select> <br>";
-
-  //Pin - Hardware implementation detail exposed for configuration
-  htmlForm += "<label for=\"pin";
-  htmlForm += index;
-  htmlForm += "\"><span>Hardware pin</span></label>";
-  
-  /*As a number field 
-  htmlForm += "<input ";
-  if( switchEntry[index]->type == SWITCH_RELAY_NC || 
-      switchEntry[index]->type == SWITCH_RELAY_NO || 
-      sizeof( pinMap ) == 0 ) 
-  {
-    htmlForm += "disabled" ;
-  }
-  htmlForm += " type=\"number\" id=\"pin";
-  htmlForm += " id=\"pin";
-  htmlForm += index;
-  htmlForm += "\" name=\"pin";
-  htmlForm += index;
-  htmlform += "\" default=\"";
-  htmlForm += switchEntry[index]->pin;
-  htmlForm += "\" min=\"";
-  htmlForm += MINPIN;  
-  htmlForm += "\" max=\"";
-  htmlForm += MAXPIN;
-  htmlForm += "\" >
-  
-  */
-  //As a select with options 
-  //<select> <option value="audi">Audi</option> </select>
-  htmlForm += "<select ";
-  if( switchEntry[index]->type == SWITCH_RELAY_NC || 
-      switchEntry[index]->type == SWITCH_RELAY_NO || 
-      sizeof( pinMap ) == 0 ) 
-  {
-    htmlForm += "disabled" ;
-  } 
-  
-  htmlForm += " id=\"pin";
-  htmlForm += index;
-  htmlForm += "\" name=\"pin";
-  htmlForm += index;
-  htmlForm += "\">";
-  
-  int i=0;
-  while ( pinMap[i] != NULLPIN )
-  {
-    htmlForm += "<option value=\"";
-    htmlForm += pinMap[i];
-    htmlForm += "\">";
-    htmlForm += String( pinMap[i] );
-    htmlForm += "</option>";
-    i++;
-  };
-  htmlForm += "</select><br>";  
-  
-  //Min value for switch 
-  htmlForm += "<label for=\"min";
-  htmlForm += index;
-  htmlForm += "\"><span>Switch min value</span></label>";
-  htmlForm += "<input type=\"number\" id=\"min";
-  htmlForm += index;
-  htmlForm += "\" name=\"min";
-  htmlForm += index;
-  htmlForm += "\" value=\"";
-  htmlForm += switchEntry[index]->min;
-  htmlForm += "\" min=\"";
-  if( switchEntry[index]->type == SWITCH_RELAY_NC || switchEntry[index]->type == SWITCH_RELAY_NO ) 
-  {
-    htmlForm += MINVAL;  
-    htmlForm += "\" max=\"";
-    htmlForm += MAXBINARYVAL;
-    htmlForm += "\" disabled><br>";  
-  }
-  else
-  {
-    htmlForm += MINVAL;  
-    htmlForm += "\" max=\"";
-    htmlForm += MAXDIGITALVAL;
-    htmlForm += "\"><br>";  
-  }
-
-  //Max value for switch
-  htmlForm += "<label for=\"max";
-  htmlForm += index;
-  htmlForm += "\"><span>Max value</span></label>";
-  htmlForm += "<input type=\"number\" id=\"max";
-  htmlForm += index;
-  htmlForm += "\" name=\"max";
-  htmlForm += index;
-  htmlForm += "\" value=\"";
-  htmlForm += switchEntry[index]->max;
-  htmlForm += "\" min=\"";
-  if( switchEntry[index]->type == SWITCH_RELAY_NC || switchEntry[index]->type == SWITCH_RELAY_NO ) 
-  {
-    htmlForm += MINVAL;  
-    htmlForm += "\" max=\"";
-    htmlForm += MAXBINARYVAL;
-    htmlForm += "\" disabled><br>";  
-  }
-  else
-  {
-    htmlForm += MINVAL;  
-    htmlForm += "\" max=\"";
-    htmlForm += MAXDIGITALVAL;
-    htmlForm += "\" ><br>";  
-  }
-  
-  //Step - number of steps in range for switch
-  htmlForm += "<label for=\"step";
-  htmlForm += index;
-  htmlForm += "\"><span>Steps in range</span></label>";
-  htmlForm += "<input type=\"number\" id=\"step";
-  htmlForm += index;
-  htmlForm += "\" name=\"step";
-  htmlForm += index;
-  htmlForm += "\" value=\"";
-  htmlForm += switchEntry[index]->step;
-  htmlForm += "\" min=\"";
-  if( switchEntry[index]->type == SWITCH_RELAY_NC || switchEntry[index]->type == SWITCH_RELAY_NO ) 
-  {
-    htmlForm += MINVAL;  
-    htmlForm += "\" max=\"";
-    htmlForm += MAXBINARYVAL;
-    htmlForm += "\" disabled ><br>";  
-  }
-  else
-  {
-    htmlForm += MINVAL;  
-    htmlForm += "\" max=\"";
-    htmlForm += MAXDIGITALVAL;
-    htmlForm += "\" ><br>";  
-  }
-
-  //Writeable
-  htmlForm += "<label for=\"writeable";
-  htmlForm += index;
-  htmlForm += "\"><span>Writeable</span></label>";
-  htmlForm += " &nbsp; <input type=\"radio\" value=\"on\" id=\"writeable";
-  htmlForm += index;
-  htmlForm += "\" name=\"writeable";
-  htmlForm += index;
-  htmlForm += "\""; 
-  if( switchEntry[index]->writeable )
-    htmlForm += " checked";
-  htmlForm += ">";
-  htmlForm += "<label for=\"writeableB";
-  htmlForm += index;
-  htmlForm += "\"><span>ReadOnly</span></label>";
-  htmlForm += " &nbsp; <input type=\"radio\" value=\"off\" id=\"writeableB";
-  htmlForm += index;
-  htmlForm += "\" name=\"writeable";
-  htmlForm += index;
-  htmlForm += "\""; 
-  if( !switchEntry[index]->writeable )
-    htmlForm += " checked";
-  htmlForm += "> <br>";
- 
-  //Form submit button. 
-  htmlForm += "<input type=\"submit\" value=\"Update\">";
-  htmlForm += "</fieldset> "; 
-  htmlForm += "</form></div></div>";
-
-  return htmlForm;
-}
-
-//footer
-String& setupFormBuilderFooter( String& htmlForm )
-{
-  //restart button
-  htmlForm =  F("<div class=\"row float-left\" id=\"restartField\" >");
-  htmlForm += F("<div class=\"col-sm-12\"><h2> Restart device</h2>");
-  htmlForm += F("<form class=\"form-inline\" method=\"POST\" action=\"http://");
-  htmlForm.concat( myHostname );
-  htmlForm += F("/restart\">");
-  htmlForm += F("<input type=\"submit\" class=\"btn btn-default\" value=\"Restart device\" />");
-  htmlForm += F("</form>");
-  htmlForm += F("</div></div>");
-  
-  //Update button
-  htmlForm += F("<div class=\"row float-left\" id=\"updateField\" >");
-  htmlForm += F("<div class=\"col-sm-12\"><h2> Update firmware</h2>");
-  htmlForm += F("<form class=\"form-inline\" method=\"GET\"  action=\"http://");
-  htmlForm.concat( myHostname );
-  htmlForm += F("/update\">");
-  htmlForm += F("<input type=\"submit\" class=\"btn btn-default\" value=\"Update firmware\" />");
-  htmlForm += F("</form>");
-  htmlForm += F("</div></div>");
-
-  //Close page
-  htmlForm += F("<div class=\"row float-left\" id=\"positions\">");
-  htmlForm += F("<div class=\"col-sm-12\"><br> </div></div>");
-  htmlForm += F("</div></body></html>");
-  return htmlForm;
-}
 #endif
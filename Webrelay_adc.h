@@ -0,0 +1,289 @@
+/*
+File to define the ADS1015 voltage monitor acquisition for the ASCOM switch web driver.
+The library call readADC_SingleEnded() starts a conversion and then delay()s until it must be finished, so reading the
+channels every timer tick blocked the web server, MQTT and discovery for the whole sweep.
+
+Here each conversion is started with one register write and loop() carries on. A later pass of serviceAdc() collects
+the result once the conversion time has passed and the device reports it idle, then starts the next channel - so a
+sweep is spread over several loop passes and no pass waits on the converter.
+
+Sweeps run every ADC_SWEEP_INTERVAL_MS rather than on the 500ms timer, so short dips such as the 12v rail sagging as a
+dew heater switches in are caught. Each channel costs a config write, a status poll or two and a result read on the
+I2C bus the relay expander shares, so the interval is kept well above the few milliseconds a sweep takes - define
+ADC_SWEEP_INTERVAL_MS to trade bus time for resolution. Each channel keeps the last ADC_WINDOW_LENGTH samples, in
+millivolts at the input, in a ring with a running sum and two monotonic queues of sample numbers - one rising for the
+minimum, one falling for the maximum - so the mean, trough and peak over the window are read in constant time and each
+sample costs amortised constant time to add.
+
+The gain is chosen per channel for every conversion from the one before. A reading at the top of the range steps to
+the next wider range and is dropped rather than recorded clipped. A reading that would still be below ADC_RANGE_LOW_TARGET
+on the next narrower range steps down to it. The gap between the two thresholds stops the gain hunting.
+The gain LSB size and the channel's resistor divider are folded into one Q14 multiplier per channel and gain step when the
+ADC is set up, so a sample is turned into input millivolts with one integer multiply and shift.
+A sweep only bumps stateGeneration - and so the /status ETag - when a channel's latest reading, trough or peak has moved
+ADC_CHANGE_MV since the last bump, otherwise the noise would make every poll a change.
+*/
+#ifndef _WEBRELAY_ADC_H_
+#define _WEBRELAY_ADC_H_
+
+#if defined USE_ADC
+#include "Webrelay_common.h"
+#include <Wire.h>
+
+const uint8_t ADC_I2C_ADDRESS = 0x48;          //ADDR pin to ground
+const uint8_t ADC_REG_CONVERSION = 0x00;
+const uint8_t ADC_REG_CONFIG = 0x01;
+const uint16_t ADC_CONFIG_OS_SINGLE = 0x8000;  //Write: start a conversion. Read: 1 when idle
+const uint16_t ADC_CONFIG_MUX_SINGLE_0 = 0x4000; //AINn against GND, channels follow at 0x1000 steps
+const uint16_t ADC_CONFIG_MODE_SINGLE = 0x0100;
+const uint16_t ADC_CONFIG_DR_1600SPS = 0x0080;
+const uint16_t ADC_CONFIG_COMP_DISABLE = 0x0003;
+const unsigned long ADC_CONVERSION_MS = 1;     //1600 samples/s is 625us a conversion
+const unsigned long ADC_TIMEOUT_MS = 20;       //Give up on a channel that never reports idle
+#if !defined ADC_SWEEP_INTERVAL_MS
+#define ADC_SWEEP_INTERVAL_MS 100UL
+#endif
+
+//Single ended readings are the positive half of a 12 bit two's complement result
+const uint16_t ADC_FULL_SCALE = 2047;
+const uint16_t ADC_RANGE_CLIPPED = 2040;    //At or above this, move to a wider range
+const uint16_t ADC_RANGE_LOW_TARGET = 1536; //Move to a narrower range if the reading would still be below this there
+const uint16_t adcFullScaleMv[] = { 6144, 4096, 2048, 1024, 512, 256 }; //Per adcGainConstants step
+const int ADC_MULTIPLIER_SHIFT = 14;
+const int ADC_CHANGE_MV = 20;
+
+//Samples per channel in the rolling window - ADC_WINDOW_LENGTH * ADC_SWEEP_INTERVAL_MS is the span covered.
+#if !defined ADC_WINDOW_LENGTH
+#define ADC_WINDOW_LENGTH 64
+#endif
+static_assert( ( ADC_WINDOW_LENGTH & ( ADC_WINDOW_LENGTH - 1 ) ) == 0 && ADC_WINDOW_LENGTH <= 128,
+               "ADC_WINDOW_LENGTH must be a power of 2 no more than 128" );
+
+typedef struct
+{
+  uint16_t samples[ ADC_WINDOW_LENGTH ];  //Millivolts at the input, indexed by sample number modulo the length
+  uint16_t minQueue[ ADC_WINDOW_LENGTH ]; //Sample numbers with rising values - the front is the minimum
+  uint16_t maxQueue[ ADC_WINDOW_LENGTH ]; //Sample numbers with falling values - the front is the maximum
+  uint8_t minHead, minCount;
+  uint8_t maxHead, maxCount;
+  uint16_t next;                          //Number of the next sample, wraps
+  uint16_t count;                         //Samples in the window, up to ADC_WINDOW_LENGTH
+  uint32_t sum;
+} AdcWindow;
+
+enum AdcState { ADC_IDLE, ADC_CONVERTING };
+
+AdcState adcState = ADC_IDLE;
+int adcSweepChannel = 0;
+unsigned long adcStartMs = 0;
+unsigned long adcSweepMs = 0;
+AdcWindow adcWindow[ adcChannelMax ];
+uint32_t adcMultiplier[ adcChannelMax ][ ADCGainSize ]; //Q14 input millivolts per count
+uint16_t adcMillivolts[ adcChannelMax ];                //Latest reading at the input
+uint16_t adcChangeMv[ adcChannelMax ][3];               //Latest, min and max as of the last stateGeneration bump
+
+//definitions
+bool adcBegin( void );
+void startAdcSweep( void );
+void serviceAdc( void );
+void adcWindowAdd( AdcWindow& w, uint16_t millivolts );
+float adcVolts( uint16_t millivolts );
+
+//Drop the front of a queue once its sample has left the window
+void adcQueueExpire( uint16_t* queue, uint8_t& head, uint8_t& count, uint16_t next )
+{
+  while ( count > 0 && (uint16_t) ( next - queue[head] ) >= ADC_WINDOW_LENGTH )
+  {
+    head = ( head + 1 ) & ( ADC_WINDOW_LENGTH - 1 );
+    count--;
+  }
+}
+
+uint16_t adcQueueBack( uint16_t* queue, uint8_t head, uint8_t count )
+{
+  return queue[ ( head + count - 1 ) & ( ADC_WINDOW_LENGTH - 1 ) ];
+}
+
+void adcWindowAdd( AdcWindow& w, uint16_t millivolts )
+{
+  const uint16_t mask = ADC_WINDOW_LENGTH - 1;
+  uint16_t n = w.next;
+
+  if ( w.count == ADC_WINDOW_LENGTH )
+    w.sum -= w.samples[ n & mask ];
+  else
+    w.count++;
+  w.samples[ n & mask ] = millivolts;
+  w.sum += millivolts;
+
+  adcQueueExpire( w.minQueue, w.minHead, w.minCount, n );
+  while ( w.minCount > 0 && w.samples[ adcQueueBack( w.minQueue, w.minHead, w.minCount ) & mask ] >= millivolts )
+    w.minCount--;
+  w.minQueue[ ( w.minHead + w.minCount++ ) & mask ] = n;
+
+  adcQueueExpire( w.maxQueue, w.maxHead, w.maxCount, n );
+  while ( w.maxCount > 0 && w.samples[ adcQueueBack( w.maxQueue, w.maxHead, w.maxCount ) & mask ] <= millivolts )
+    w.maxCount--;
+  w.maxQueue[ ( w.maxHead + w.maxCount++ ) & mask ] = n;
+
+  w.next = n + 1;
+}
+
+uint16_t adcWindowMean( AdcWindow& w )    { return ( w.count > 0 ) ? (uint16_t) ( w.sum / w.count ) : 0; }
+uint16_t adcWindowMin( AdcWindow& w )     { return ( w.minCount > 0 ) ? w.samples[ w.minQueue[w.minHead] & ( ADC_WINDOW_LENGTH - 1 ) ] : 0; }
+uint16_t adcWindowMax( AdcWindow& w )     { return ( w.maxCount > 0 ) ? w.samples[ w.maxQueue[w.maxHead] & ( ADC_WINDOW_LENGTH - 1 ) ] : 0; }
+
+float adcVolts( uint16_t millivolts )
+{
+  return millivolts / 1000.0F;
+}
+
+bool adcWriteRegister( uint8_t reg, uint16_t value )
+{
+  Wire.beginTransmission( ADC_I2C_ADDRESS );
+  Wire.write( reg );
+  Wire.write( (uint8_t) ( value >> 8 ) );
+  Wire.write( (uint8_t) ( value & 0xFF ) );
+  return ( Wire.endTransmission() == 0 );
+}
+
+bool adcReadRegister( uint8_t reg, uint16_t& value )
+{
+  Wire.beginTransmission( ADC_I2C_ADDRESS );
+  Wire.write( reg );
+  if ( Wire.endTransmission() != 0 || Wire.requestFrom( ADC_I2C_ADDRESS, (uint8_t) 2 ) != 2 )
+    return false;
+  value = ( (uint16_t) Wire.read() << 8 );
+  value |= Wire.read();
+  return true;
+}
+
+//Only the channels /status and publishADC report - a change nobody can see must not break the cached /status ETag
+void adcCheckChanged( void )
+{
+  for ( int i = 0; i < lastChannel && i < adcChannelMax; i++ )
+  {
+    uint16_t now[3] = { adcMillivolts[i], adcWindowMin( adcWindow[i] ), adcWindowMax( adcWindow[i] ) };
+    bool changed = false;
+
+    for ( int j = 0; j < 3; j++ )
+      changed |= ( abs( (int) now[j] - (int) adcChangeMv[i][j] ) >= ADC_CHANGE_MV );
+    if ( changed )
+    {
+      memcpy( adcChangeMv[i], now, sizeof( now ) );
+      stateGeneration++;
+    }
+  }
+}
+
+//Kick off a single shot conversion of one channel at its current gain setting.
+bool adcStartConversion( int channel )
+{
+  uint16_t config = ADC_CONFIG_OS_SINGLE | ADC_CONFIG_MODE_SINGLE | ADC_CONFIG_DR_1600SPS | ADC_CONFIG_COMP_DISABLE;
+
+  config |= ADC_CONFIG_MUX_SINGLE_0 + ( channel << 12 );
+  config |= (uint16_t) adcGainConstants[ adcGainSettings[channel] ];
+  adcStartMs = millis();
+  return adcWriteRegister( ADC_REG_CONFIG, config );
+}
+
+/*
+ * Probe for the ADC and work out the conversion multipliers. Every channel starts on the widest range and autoranges
+ * from there over the first few sweeps.
+ */
+bool adcBegin( void )
+{
+  uint16_t config = 0;
+  int i = 0, k = 0;
+
+  for ( i = 0; i < adcChannelMax; i++ )
+  {
+    adcGainSettings[i] = 0;
+    for ( k = 0; k < ADCGainSize; k++ )
+      adcMultiplier[i][k] = (uint32_t) ( adcGainFactor[k] * 1000.0F * adcScaleFactor[i] * ( 1UL << ADC_MULTIPLIER_SHIFT ) + 0.5F );
+  }
+  adcPresent = adcReadRegister( ADC_REG_CONFIG, config );
+  return adcPresent;
+}
+
+//Pick the gain step for the next conversion on a channel from its last raw reading. Returns true if it changed.
+bool adcAutorange( int channel, uint16_t raw )
+{
+  int k = adcGainSettings[channel];
+
+  if ( raw >= ADC_RANGE_CLIPPED && k > 0 )
+    k--;
+  else if ( k + 1 < ADCGainSize && (uint32_t) raw * adcFullScaleMv[k] < (uint32_t) ADC_RANGE_LOW_TARGET * adcFullScaleMv[k + 1] )
+    k++;
+  else
+    return false;
+  adcGainSettings[channel] = k;
+  return true;
+}
+
+/*
+ * Start a sweep of all the channels in use. A sweep still in progress is left to finish.
+ */
+void startAdcSweep( void )
+{
+  if ( !adcPresent || adcState != ADC_IDLE )
+    return;
+
+  adcSweepChannel = 0;
+  adcSweepMs = millis();
+  if ( adcStartConversion( adcSweepChannel ) )
+    adcState = ADC_CONVERTING;
+  else
+    DEBUGSL1( "startAdcSweep: failed to start conversion" );
+}
+
+/*
+ * Call every pass of the loop. Returns straight away unless a sweep or a conversion result is due.
+ */
+void serviceAdc( void )
+{
+  uint16_t config = 0;
+  uint16_t raw = 0;
+  int i = adcSweepChannel;
+
+  if ( adcState == ADC_IDLE && ( millis() - adcSweepMs ) >= ADC_SWEEP_INTERVAL_MS )
+  {
+    startAdcSweep();
+    return;
+  }
+  if ( adcState != ADC_CONVERTING || ( millis() - adcStartMs ) < ADC_CONVERSION_MS )
+    return;
+
+  if ( !adcReadRegister( ADC_REG_CONFIG, config ) || !( config & ADC_CONFIG_OS_SINGLE ) )
+  {
+    //Still converting - or the bus hiccupped, in which case try again next pass until the timeout
+    if ( ( millis() - adcStartMs ) < ADC_TIMEOUT_MS )
+      return;
+    DEBUG_ESP( "serviceAdc: channel %d timed out\n", i );
+  }
+  else if ( adcReadRegister( ADC_REG_CONVERSION, raw ) )
+  {
+    //12 bit result left justified in the 16 bit register - single ended inputs only read below 0 through noise
+    int k = adcGainSettings[i];
+
+    raw = ( raw & 0x8000 ) ? 0 : ( raw >> 4 );
+    //A clipped reading says nothing about the voltage other than it is higher - wait for the wider range
+    if ( !( adcAutorange( i, raw ) && raw >= ADC_RANGE_CLIPPED ) )
+    {
+      adcReading[i] = raw;
+      adcReadingGain[i] = k;
+      adcMillivolts[i] = (uint16_t) ( ( raw * adcMultiplier[i][k] ) >> ADC_MULTIPLIER_SHIFT );
+      adcWindowAdd( adcWindow[i], adcMillivolts[i] );
+    }
+  }
+
+  adcSweepChannel++;
+  if ( adcSweepChannel <= lastChannel && adcSweepChannel < adcChannelMax && adcStartConversion( adcSweepChannel ) )
+    return;
+
+  adcCheckChanged();
+  adcState = ADC_IDLE;
+}
+#endif //USE_ADC
+
+#endif
@@ -0,0 +1,197 @@
+/*
+File to define the request argument index for the ASCOM switch web driver.
+The request arguments are walked once per request and each name is case-folded and hashed (32 bit FNV-1a) into a
+small fixed table. Handlers then look arguments up by a hash worked out at compile time with argKeyHash("Id") instead
+of calling hasArgIC() and server.arg() repeatedly, each of which is a linear case-insensitive scan building Strings.
+Integer and float conversions are cached per argument so asking twice does not parse twice.
+
+Names with a switch number appended by the setup form (name0, min3 ...) are looked up with argKeyHashIndexed(), which
+carries on the hash of the base name over the digits of the number, so no String is built for the name.
+
+The index is filled before the handler runs - by the api dispatcher in Webrelay_routes.h and by withRequestArgs()
+for routes registered on the server directly.
+*/
+#ifndef _WEBRELAY_ARGS_H_
+#define _WEBRELAY_ARGS_H_
+
+#include "Webrelay_common.h"
+#include <ESP8266WebServer.h>
+
+//setswitches takes up to MAXSWITCH Id/State pairs plus the client ids
+const int MAX_REQUEST_ARGS = 40;
+
+const uint32_t ARG_HASH_OFFSET = 2166136261UL;
+const uint32_t ARG_HASH_PRIME = 16777619UL;
+
+constexpr char argFoldCase( char c )
+{
+  return ( c >= 'A' && c <= 'Z' ) ? (char) ( c - 'A' + 'a' ) : c;
+}
+
+constexpr uint32_t argKeyHash( const char* s, uint32_t h = ARG_HASH_OFFSET )
+{
+  return ( *s == '\0' ) ? h : argKeyHash( s + 1, ( h ^ (uint8_t) argFoldCase( *s ) ) * ARG_HASH_PRIME );
+}
+
+//Hash of the base name with the decimal form of index appended, e.g. argKeyHashIndexed( argKeyHash("min"), 3 ) == argKeyHash("min3")
+uint32_t argKeyHashIndexed( uint32_t baseHash, int index )
+{
+  char digits[12];
+  int i = 0;
+  uint32_t h = baseHash;
+
+  if ( index < 0 )
+  {
+    h = ( h ^ (uint8_t) '-' ) * ARG_HASH_PRIME;
+    index = -index;
+  }
+  do
+  {
+    digits[i++] = '0' + ( index % 10 );
+    index /= 10;
+  } while ( index > 0 );
+  while ( i > 0 )
+    h = ( h ^ (uint8_t) digits[--i] ) * ARG_HASH_PRIME;
+  return h;
+}
+
+//Keys used by the handlers
+constexpr uint32_t ARG_CLIENT_ID        = argKeyHash( "ClientID" );
+constexpr uint32_t ARG_CLIENT_TRANS_ID  = argKeyHash( "ClientTransactionID" );
+constexpr uint32_t ARG_ID               = argKeyHash( "Id" );
+constexpr uint32_t ARG_STATE            = argKeyHash( "State" );
+constexpr uint32_t ARG_VALUE            = argKeyHash( "Value" );
+constexpr uint32_t ARG_NAME             = argKeyHash( "Name" );
+constexpr uint32_t ARG_HOSTNAME         = argKeyHash( "hostname" );
+constexpr uint32_t ARG_LOCATION         = argKeyHash( "location" );
+constexpr uint32_t ARG_DISCOVERY_PORT   = argKeyHash( "discoveryport" );
+constexpr uint32_t ARG_NUM_SWITCHES     = argKeyHash( "numSwitches" );
+constexpr uint32_t ARG_RESET            = argKeyHash( "reset" );
+//Setup form fields - sent with the switch number appended
+constexpr uint32_t ARG_SWITCH_ID        = argKeyHash( "switchId" );
+constexpr uint32_t ARG_FORM_NAME        = argKeyHash( "name" );
+constexpr uint32_t ARG_FORM_DESCRIPTION = argKeyHash( "description" );
+constexpr uint32_t ARG_FORM_TYPE        = argKeyHash( "type" );
+constexpr uint32_t ARG_FORM_WRITEABLE   = argKeyHash( "writeable" );
+constexpr uint32_t ARG_FORM_PIN         = argKeyHash( "pin" );
+constexpr uint32_t ARG_FORM_MIN         = argKeyHash( "min" );
+constexpr uint32_t ARG_FORM_MAX         = argKeyHash( "max" );
+constexpr uint32_t ARG_FORM_STEP        = argKeyHash( "step" );
+
+class RequestArgs
+{
+  public:
+    RequestArgs() : _server( nullptr ), _count( 0 ) {}
+
+    //Index the arguments of the request the server is currently handling.
+    void parse( WebServerType& server )
+    {
+      int n = server.args();
+
+      _server = &server;
+      if ( n > MAX_REQUEST_ARGS )
+      {
+        DEBUGS1( "RequestArgs: arguments ignored beyond " ); DEBUGSL1( MAX_REQUEST_ARGS );
+        n = MAX_REQUEST_ARGS;
+      }
+      for ( _count = 0; _count < n; _count++ )
+      {
+        _args[_count].hash = hashName( server.argName( _count ).c_str() );
+        _args[_count].flags = 0;
+      }
+    }
+
+    //Position of the first argument with this key, or -1.
+    int find( uint32_t key )
+    {
+      for ( int i = 0; i < _count; i++ )
+        if ( _args[i].hash == key )
+          return i;
+      return -1;
+    }
+
+    bool has( uint32_t key )                          { return find( key ) >= 0; }
+    long getInt( uint32_t key, long defaultValue = 0 )
+    {
+      int i = find( key );
+      return ( i >= 0 ) ? intAt( i ) : defaultValue;
+    }
+    float getFloat( uint32_t key, float defaultValue = 0.0F )
+    {
+      int i = find( key );
+      return ( i >= 0 ) ? floatAt( i ) : defaultValue;
+    }
+    bool isTrue( uint32_t key )
+    {
+      int i = find( key );
+      return ( i >= 0 ) && isTrueAt( i );
+    }
+    bool isEqual( uint32_t key, const char* match )
+    {
+      int i = find( key );
+      return ( i >= 0 ) && valueAt( i ).equalsIgnoreCase( match );
+    }
+    const String& value( uint32_t key )
+    {
+      int i = find( key );
+      return ( i >= 0 ) ? valueAt( i ) : _empty;
+    }
+
+    //Positional access for handlers that take repeated arguments, in the order they were sent.
+    int count( void )                 { return _count; }
+    uint32_t keyAt( int i )           { return _args[i].hash; }
+    const String& valueAt( int i )    { return _server->arg( i ); }
+    bool isTrueAt( int i )            { return valueAt( i ).equalsIgnoreCase( "true" ); }
+    long intAt( int i )
+    {
+      if ( !( _args[i].flags & ARG_INT_PARSED ) )
+      {
+        _args[i].intValue = valueAt( i ).toInt();
+        _args[i].flags |= ARG_INT_PARSED;
+      }
+      return _args[i].intValue;
+    }
+    float floatAt( int i )
+    {
+      if ( !( _args[i].flags & ARG_FLOAT_PARSED ) )
+      {
+        _args[i].floatValue = valueAt( i ).toFloat();
+        _args[i].flags |= ARG_FLOAT_PARSED;
+      }
+      return _args[i].floatValue;
+    }
+
+  private:
+    static const uint8_t ARG_INT_PARSED = 0x01;
+    static const uint8_t ARG_FLOAT_PARSED = 0x02;
+
+    typedef struct
+    {
+      uint32_t hash;
+      uint8_t flags;
+      long intValue;
+      float floatValue;
+    } IndexedArg;
+
+    WebServerType* _server;
+    int _count;
+    IndexedArg _args[ MAX_REQUEST_ARGS ];
+    const String _empty;
+
+    static uint32_t hashName( const char* s )
+    {
+      uint32_t h = ARG_HASH_OFFSET;
+      for ( ; *s; s++ )
+        h = ( h ^ (uint8_t) argFoldCase( *s ) ) * ARG_HASH_PRIME;
+      return h;
+    }
+};
+
+RequestArgs requestArgs;
+
+//Wrap a handler registered directly on the server so the argument index is filled before it runs.
+WebServerType::THandlerFunction withRequestArgs( WebServerType::THandlerFunction fn )
+{
+  return [fn]() { requestArgs.parse( server ); fn(); };
+}
+#endif
@@ -0,0 +1,639 @@
+/*
+File to define the event driven web server used for the ASCOM switch web driver when built with USE_ASYNC_SERVER.
+ESP8266WebServer serves one connection at a time from loop(), reading each request synchronously, so when several
+clients - an imaging program, the ASCOM Remote chooser and a dashboard poller - talk to the device together they queue
+behind each other, and a client that is slow to send its request holds up everyone behind it.
+
+Here connections are accepted by ESPAsyncTCP and each of up to ASYNC_MAX_CONNECTIONS has its own request buffer and
+parse state, filled from the TCP callbacks as data arrives. A connection is only handed to a handler once its whole
+request - headers and body - is in, so a slow client holds nothing but its own slot and is dropped after
+ASYNC_RX_TIMEOUT_S. The handlers still run from loop() - they drive the I2C bus, EEPROM and MQTT client, none of which
+may be used from the network callbacks - and every complete request waiting is served in the same pass, taking turns
+in order around the slots.
+
+AsyncWebServerAdapter presents the part of the ESP8266WebServer interface the handlers use - method(), args(),
+send(), sendContent() and so on - so the same handler functions, argument index and route table serve both builds.
+The response is written straight to the connection; only a response bigger than the TCP send buffer waits for acks,
+and the whole response gets no more than ASYNC_WRITE_TIMEOUT_MS, however slowly the client acks - past that the
+connection is dropped and the rest of the response discarded.
+Responses are sent with the request's HTTP version. HTTP/1.0 clients can't take chunked bodies, so a response of
+unknown length goes to them unchunked and the connection is closed to end it, as ESP8266WebServer does.
+Firmware updates need the upload support of ESP8266WebServer so they stay on one, on UPDATE_SERVER_PORT.
+
+HTTP/1.1 connections are kept open after the response unless the client asks otherwise, so a poller calling
+getswitch many times a second pays for one handshake rather than one per poll, and the device doesn't collect a
+TIME_WAIT entry per poll. At most ASYNC_KEEPALIVE_MAX connections are kept at once, leaving the other slots for
+one-off requests; past that the response carries Connection: close. A kept connection with nothing sent for
+ASYNC_KEEPALIVE_IDLE_S is closed. Requests may be pipelined - whatever arrives behind the request being served is kept
+in the buffer and served next - but each connection gets one request per loop pass, so a client pipelining a burst of
+polls takes turns with the others. Pipelined requests that don't fit the buffer close the connection after the
+response, for the client to send again.
+*/
+#ifndef _WEBRELAY_ASYNC_H_
+#define _WEBRELAY_ASYNC_H_
+
+#if defined USE_ASYNC_SERVER
+#include "Webrelay_common.h"
+#include <ESPAsyncTCP.h>       //https://github.com/me-no-dev/ESPAsyncTCP
+#include <ESP8266WebServer.h>  //HTTPMethod and the content length constants
+#include <functional>
+
+#if !defined ASYNC_MAX_CONNECTIONS
+#define ASYNC_MAX_CONNECTIONS 4
+#endif
+#if !defined ASYNC_REQUEST_SIZE
+#define ASYNC_REQUEST_SIZE 1024
+#endif
+const int ASYNC_MAX_ROUTES = 24;
+const int ASYNC_MAX_ARGS = 40;        //As MAX_REQUEST_ARGS
+const int ASYNC_HEADER_SIZE = 256;
+const uint32_t ASYNC_RX_TIMEOUT_S = 5;
+const int ASYNC_KEEPALIVE_MAX = 2;
+const uint32_t ASYNC_KEEPALIVE_IDLE_S = 10;
+const unsigned long ASYNC_WRITE_TIMEOUT_MS = 2000;
+static const char ASYNC_BUSY_RESPONSE[] = "HTTP/1.1 503 Service Unavailable\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+
+enum AsyncConnectionState { ASYNC_FREE, ASYNC_READING, ASYNC_READY, ASYNC_HANDLING, ASYNC_CLOSING };
+
+typedef struct
+{
+  AsyncClient* client;              //nullptr once disconnected
+  volatile uint8_t state;           //AsyncConnectionState
+  bool overflow;                    //Request bigger than the buffer
+  bool dropped;                     //Pipelined data lost for want of room - close after this response
+  bool persistent;                  //Kept open after a response
+  uint16_t length;                  //Bytes in request
+  uint16_t headerLength;            //Offset of the body, 0 until the blank line has arrived
+  uint32_t contentLength;
+  char request[ ASYNC_REQUEST_SIZE + 1 ];
+} AsyncConnection;
+
+class AsyncWebServerAdapter;
+
+//As ESP8266WebServer's RequestHandler, for the api route table
+class AsyncRequestHandler
+{
+  public:
+    virtual ~AsyncRequestHandler() {}
+    virtual bool canHandle( HTTPMethod method, const String& uri ) = 0;
+    virtual bool canUpload( const String& uri ) { (void) uri; return false; }
+    virtual bool handle( AsyncWebServerAdapter& server, HTTPMethod requestMethod, const String& requestUri ) = 0;
+};
+
+class AsyncWebServerAdapter
+{
+  public:
+    typedef std::function<void(void)> THandlerFunction;
+
+    AsyncWebServerAdapter( uint16_t port ) : _tcp( port ), _routeCount( 0 ), _handler( nullptr ), _next( 0 ), _current( nullptr )
+    {
+      memset( _connections, 0, sizeof( _connections ) );
+      resetResponse();
+    }
+
+    //Registration
+    void on( const char* uri, HTTPMethod method, THandlerFunction fn )
+    {
+      if ( _routeCount >= ASYNC_MAX_ROUTES )
+      {
+        DEBUG_ESP( "AsyncWebServerAdapter: no room for route %s\n", uri );
+        return;
+      }
+      _routes[_routeCount].uri = uri;
+      _routes[_routeCount].method = method;
+      _routes[_routeCount].fn = fn;
+      _routeCount++;
+    }
+    void on( const char* uri, THandlerFunction fn )      { on( uri, HTTP_ANY, fn ); }
+    void onNotFound( THandlerFunction fn )               { _notFound = fn; }
+    void addHandler( AsyncRequestHandler* handler )      { _handler = handler; }
+    //If-None-Match is always kept - the only request header the handlers read
+    void collectHeaders( const char* headerKeys[], const size_t count ) { (void) headerKeys; (void) count; }
+
+    void begin( void )
+    {
+      _tcp.onClient( []( void* arg, AsyncClient* c ) { ( (AsyncWebServerAdapter*) arg )->onConnect( c ); }, this );
+      _tcp.setNoDelay( true );
+      _tcp.begin();
+    }
+
+    /*
+     * Call every pass of the loop. Runs the handler for each connection with a complete request.
+     */
+    void handleClient( void )
+    {
+      for ( int n = 0; n < ASYNC_MAX_CONNECTIONS; n++ )
+      {
+        int i = ( _next + n ) % ASYNC_MAX_CONNECTIONS;
+        if ( _connections[i].state == ASYNC_READY )
+          handleRequest( _connections[i] );
+      }
+      _next = ( _next + 1 ) % ASYNC_MAX_CONNECTIONS;
+    }
+
+    //Request - valid while a handler runs
+    HTTPMethod method( void )                  { return _method; }
+    const String& uri( void )                  { return _uri; }
+    int args( void )                           { return _argCount; }
+    const String& arg( int i )                 { return ( i >= 0 && i < _argCount ) ? _argValues[i] : _empty; }
+    const String& argName( int i )             { return ( i >= 0 && i < _argCount ) ? _argNames[i] : _empty; }
+    const String& arg( const String& name )
+    {
+      for ( int i = 0; i < _argCount; i++ )
+        if ( _argNames[i] == name )
+          return _argValues[i];
+      return _empty;
+    }
+    bool hasArg( const String& name )
+    {
+      for ( int i = 0; i < _argCount; i++ )
+        if ( _argNames[i] == name )
+          return true;
+      return false;
+    }
+    String header( const String& name )        { return ( name.equalsIgnoreCase( "If-None-Match" ) ) ? _ifNoneMatch : _empty; }
+
+    //Response
+    void setContentLength( const size_t contentLength ) { _contentLength = contentLength; }
+    void sendHeader( const String& name, const String& value, bool first = false )
+    {
+      size_t used = strlen( _headers );
+      (void) first;
+      if ( snprintf( &_headers[used], sizeof( _headers ) - used, "%s: %s\r\n", name.c_str(), value.c_str() ) >= (int) ( sizeof( _headers ) - used ) )
+      {
+        _headers[used] = '\0';
+        DEBUG_ESP( "AsyncWebServerAdapter: header %s dropped\n", name.c_str() );
+      }
+    }
+    void send( int code, const char* contentType, const String& content )
+    {
+      sendStatus( code, contentType, content.length() );
+      if ( content.length() > 0 )
+        sendContent( content.c_str(), content.length() );
+    }
+    void send( int code, const String& contentType, const String& content ) { send( code, contentType.c_str(), content ); }
+    void send_P( int code, PGM_P contentType, PGM_P content, size_t contentLength )
+    {
+      char type[48];
+      char buffer[64];
+      size_t sent = 0;
+
+      strncpy_P( type, contentType, sizeof( type ) - 1 );
+      type[ sizeof( type ) - 1 ] = '\0';
+      _contentLength = contentLength;
+      sendStatus( code, type, contentLength );
+      while ( sent < contentLength )
+      {
+        size_t n = ( contentLength - sent < sizeof( buffer ) ) ? contentLength - sent : sizeof( buffer );
+        memcpy_P( buffer, content + sent, n );
+        write( buffer, n );
+        sent += n;
+      }
+    }
+    void sendContent( const char* data, size_t len )
+    {
+      char size[12];
+
+      if ( !_chunked )
+      {
+        write( data, len );
+        return;
+      }
+      //A zero length chunk ends the response, as with ESP8266WebServer
+      snprintf( size, sizeof( size ), "%x\r\n", (unsigned int) len );
+      write( size, strlen( size ) );
+      write( data, len );
+      write( "\r\n", 2 );
+    }
+    void sendContent( const String& content ) { sendContent( content.c_str(), content.length() ); }
+    void sendContent( const char* content )   { sendContent( content, strlen( content ) ); }
+
+  private:
+    typedef struct
+    {
+      const char* uri;
+      HTTPMethod method;
+      THandlerFunction fn;
+    } AsyncRoute;
+
+    AsyncServer _tcp;
+    AsyncConnection _connections[ ASYNC_MAX_CONNECTIONS ];
+    AsyncRoute _routes[ ASYNC_MAX_ROUTES ];
+    int _routeCount;
+    THandlerFunction _notFound;
+    AsyncRequestHandler* _handler;
+    int _next;
+
+    //The request being handled
+    AsyncConnection* _current;
+    HTTPMethod _method;
+    String _uri;
+    String _ifNoneMatch;
+    bool _keepAlive;
+    char _version;      //Minor version of the request, '0' or '1'
+    int _argCount;
+    String _argNames[ ASYNC_MAX_ARGS ];
+    String _argValues[ ASYNC_MAX_ARGS ];
+    const String _empty;
+
+    //Its response
+    char _headers[ ASYNC_HEADER_SIZE ];
+    size_t _contentLength;
+    bool _chunked;
+    bool _started;
+    bool _writeFailed;
+    unsigned long _writeStart;
+
+    void resetResponse( void )
+    {
+      _headers[0] = '\0';
+      _contentLength = CONTENT_LENGTH_NOT_SET;
+      _chunked = false;
+      _started = false;
+      _writeFailed = false;
+      _writeStart = millis();
+    }
+
+    //Network callbacks - these run outside loop() and only touch the connection's own buffer
+    void onConnect( AsyncClient* c )
+    {
+      for ( int i = 0; i < ASYNC_MAX_CONNECTIONS; i++ )
+      {
+        AsyncConnection& conn = _connections[i];
+        if ( conn.state != ASYNC_FREE )
+          continue;
+        conn.client = c;
+        conn.overflow = false;
+        conn.dropped = false;
+        conn.persistent = false;
+        conn.length = 0;
+        conn.headerLength = 0;
+        conn.contentLength = 0;
+        conn.state = ASYNC_READING;
+        c->setRxTimeout( ASYNC_RX_TIMEOUT_S );
+        c->onData( []( void* arg, AsyncClient* c, void* data, size_t len ) { onData( *(AsyncConnection*) arg, (const char*) data, len ); }, &conn );
+        c->onTimeout( []( void* arg, AsyncClient* c, uint32_t t ) { (void) arg; (void) t; c->close(); }, &conn );
+        c->onDisconnect( []( void* arg, AsyncClient* c ) { onDisconnect( *(AsyncConnection*) arg, c ); }, &conn );
+        return;
+      }
+      //All slots busy
+      c->onDisconnect( []( void* arg, AsyncClient* c ) { (void) arg; delete c; }, nullptr );
+      c->write( ASYNC_BUSY_RESPONSE, sizeof( ASYNC_BUSY_RESPONSE ) - 1 );
+      c->close();
+    }
+
+    static void onDisconnect( AsyncConnection& conn, AsyncClient* c )
+    {
+      conn.client = nullptr;
+      //A connection in the middle of its response is freed by handleRequest() when that finishes
+      if ( conn.state != ASYNC_HANDLING )
+        conn.state = ASYNC_FREE;
+      delete c;
+    }
+
+    static void onData( AsyncConnection& conn, const char* data, size_t len )
+    {
+      if ( conn.state == ASYNC_FREE || conn.state == ASYNC_CLOSING )
+        return;
+      if ( conn.length + len > ASYNC_REQUEST_SIZE )
+      {
+        //Behind a request already complete it is a pipelined one - serve what is in and then close
+        if ( conn.state == ASYNC_READING )
+        {
+          conn.overflow = true;
+          conn.state = ASYNC_READY;
+        }
+        else
+          conn.dropped = true;
+        return;
+      }
+      memcpy( &conn.request[conn.length], data, len );
+      conn.length += len;
+      conn.request[conn.length] = '\0';
+      if ( conn.state == ASYNC_READING )
+        checkRequest( conn );
+    }
+
+    //Mark the connection ready once the request at the front of the buffer is complete
+    static void checkRequest( AsyncConnection& conn )
+    {
+      if ( conn.headerLength == 0 )
+      {
+        char* end = strstr( conn.request, "\r\n\r\n" );
+        if ( end == nullptr )
+          return;
+        conn.headerLength = ( end - conn.request ) + 4;
+        conn.contentLength = findContentLength( conn.request, conn.headerLength );
+        if ( conn.headerLength + conn.contentLength > ASYNC_REQUEST_SIZE )
+        {
+          conn.overflow = true;
+          conn.state = ASYNC_READY;
+          return;
+        }
+      }
+      if ( conn.length >= conn.headerLength + conn.contentLength )
+        conn.state = ASYNC_READY;
+    }
+
+    //Value of a header within the first length bytes of the request, or nullptr. Stops at the end of its line.
+    static const char* findHeader( const char* request, size_t length, const char* name )
+    {
+      size_t nameLength = strlen( name );
+      const char* p = strstr( request, "\r\n" );
+
+      while ( p != nullptr && (size_t) ( p - request ) + 2 < length )
+      {
+        p += 2;
+        if ( strncasecmp( p, name, nameLength ) == 0 && p[nameLength] == ':' )
+        {
+          p += nameLength + 1;
+          while ( *p == ' ' )
+            p++;
+          return p;
+        }
+        p = strstr( p, "\r\n" );
+      }
+      return nullptr;
+    }
+
+    static uint32_t findContentLength( const char* request, size_t length )
+    {
+      const char* value = findHeader( request, length, "Content-Length" );
+      return ( value != nullptr ) ? strtoul( value, nullptr, 10 ) : 0;
+    }
+
+    static HTTPMethod parseMethod( const char* name )
+    {
+      if ( strcmp( name, "GET" ) == 0 )     return HTTP_GET;
+      if ( strcmp( name, "PUT" ) == 0 )     return HTTP_PUT;
+      if ( strcmp( name, "POST" ) == 0 )    return HTTP_POST;
+      if ( strcmp( name, "DELETE" ) == 0 )  return HTTP_DELETE;
+      if ( strcmp( name, "PATCH" ) == 0 )   return HTTP_PATCH;
+      if ( strcmp( name, "OPTIONS" ) == 0 ) return HTTP_OPTIONS;
+      if ( strcmp( name, "HEAD" ) == 0 )    return HTTP_HEAD;
+      return HTTP_ANY;
+    }
+
+    static int hexValue( char c )
+    {
+      if ( c >= '0' && c <= '9' ) return c - '0';
+      c = tolower( c );
+      if ( c >= 'a' && c <= 'f' ) return c - 'a' + 10;
+      return -1;
+    }
+
+    //Url decode in place
+    static void urlDecode( char* s )
+    {
+      char* out = s;
+      for ( ; *s; s++ )
+      {
+        if ( *s == '+' )
+          *out++ = ' ';
+        else if ( *s == '%' && hexValue( s[1] ) >= 0 && hexValue( s[2] ) >= 0 )
+        {
+          *out++ = (char) ( ( hexValue( s[1] ) << 4 ) | hexValue( s[2] ) );
+          s += 2;
+        }
+        else
+          *out++ = *s;
+      }
+      *out = '\0';
+    }
+
+    //Split name=value&name=value in place into the argument list
+    void parseArgs( char* p )
+    {
+      char* arg = nullptr;
+
+      while ( ( arg = strtok_r( p, "&", &p ) ) != nullptr )
+      {
+        char* eq = strchr( arg, '=' );
+        if ( _argCount >= ASYNC_MAX_ARGS )
+          return;
+        if ( eq != nullptr )
+          *eq++ = '\0';
+        urlDecode( arg );
+        _argNames[_argCount] = arg;
+        if ( eq != nullptr )
+        {
+          urlDecode( eq );
+          _argValues[_argCount] = eq;
+        }
+        else
+          _argValues[_argCount] = _empty;
+        _argCount++;
+      }
+    }
+
+    //Returns false for a malformed request line
+    bool parseRequest( AsyncConnection& conn )
+    {
+      char* p = conn.request;
+      char* methodName = strsep( &p, " " );
+      char* target = ( p != nullptr ) ? strsep( &p, " " ) : nullptr;
+      char* query = nullptr;
+      const char* header = nullptr;
+      char* body = &conn.request[ conn.headerLength ];
+      char next = body[ conn.contentLength ];
+
+      if ( target == nullptr || p == nullptr || strncmp( p, "HTTP/1.", 7 ) != 0 )
+        return false;
+      _method = parseMethod( methodName );
+      query = strchr( target, '?' );
+      if ( query != nullptr )
+        *query++ = '\0';
+      _uri = target;
+
+      //Persistent by default in 1.1, only on request in 1.0
+      header = findHeader( p, conn.headerLength - ( p - conn.request ), "Connection" );
+      _version = ( p[7] == '0' ) ? '0' : '1';
+      if ( _version == '1' )
+        _keepAlive = ( header == nullptr || strncasecmp( header, "close", 5 ) != 0 );
+      else
+        _keepAlive = ( header != nullptr && strncasecmp( header, "keep-alive", 10 ) == 0 );
+
+      header = findHeader( p, conn.headerLength - ( p - conn.request ), "If-None-Match" );
+      _ifNoneMatch = _empty;
+      if ( header != nullptr )
+      {
+        const char* end = strstr( header, "\r\n" );
+        _ifNoneMatch.concat( header, end - header );
+      }
+
+      _argCount = 0;
+      if ( query != nullptr )
+        parseArgs( query );
+      //Form bodies as ESP8266WebServer - the api and setup forms are all url encoded
+      header = findHeader( p, conn.headerLength - ( p - conn.request ), "Content-Type" );
+      if ( conn.contentLength > 0 && header != nullptr && strncasecmp( header, "application/x-www-form-urlencoded", 33 ) == 0 )
+      {
+        //The byte after the body may be the start of a pipelined request
+        body[ conn.contentLength ] = '\0';
+        parseArgs( body );
+        body[ conn.contentLength ] = next;
+      }
+      return true;
+    }
+
+    int persistentCount( void )
+    {
+      int n = 0;
+      for ( int i = 0; i < ASYNC_MAX_CONNECTIONS; i++ )
+        if ( _connections[i].state != ASYNC_FREE && _connections[i].persistent )
+          n++;
+      return n;
+    }
+
+    void handleRequest( AsyncConnection& conn )
+    {
+      _current = &conn;
+      conn.state = ASYNC_HANDLING;
+      resetResponse();
+      _keepAlive = false;
+      _version = '1';
+
+      if ( conn.overflow )
+        send( 413, "text/plain", "" );
+      else if ( !parseRequest( conn ) )
+      {
+        _keepAlive = false;
+        send( 400, "text/plain", "" );
+      }
+      else
+      {
+        _keepAlive = _keepAlive && !conn.dropped && ( conn.persistent || persistentCount() < ASYNC_KEEPALIVE_MAX );
+        dispatch();
+      }
+      if ( !_started )
+        send( 500, "text/plain", "" );
+
+      if ( conn.client != nullptr && _keepAlive && !conn.dropped )
+      {
+        //Move anything pipelined up to the front and go round again - the next pass serves it if it is complete
+        size_t used = conn.headerLength + conn.contentLength;
+        conn.client->send();
+        conn.persistent = true;
+        conn.client->setRxTimeout( ASYNC_KEEPALIVE_IDLE_S );
+        memmove( conn.request, &conn.request[used], conn.length - used );
+        conn.length -= used;
+        conn.request[conn.length] = '\0';
+        conn.headerLength = 0;
+        conn.contentLength = 0;
+        conn.state = ASYNC_READING;
+        checkRequest( conn );
+      }
+      else if ( conn.client != nullptr )
+      {
+        //close() can call onDisconnect() straight away, which frees the slot
+        AsyncClient* c = conn.client;
+        conn.state = ASYNC_CLOSING;
+        c->send();
+        c->close();
+      }
+      else
+        conn.state = ASYNC_FREE;
+      _current = nullptr;
+    }
+
+    void dispatch( void )
+    {
+      if ( _handler != nullptr && _handler->canHandle( _method, _uri ) && _handler->handle( *this, _method, _uri ) )
+        return;
+      for ( int i = 0; i < _routeCount; i++ )
+      {
+        if ( _uri == _routes[i].uri && ( _routes[i].method == HTTP_ANY || _routes[i].method == _method ) )
+        {
+          _routes[i].fn();
+          return;
+        }
+      }
+      if ( _notFound )
+        _notFound();
+    }
+
+    static const char* reason( int code )
+    {
+      switch ( code )
+      {
+        case 200: return "OK";
+        case 302: return "Found";
+        case 304: return "Not Modified";
+        case 400: return "Bad Request";
+        case 401: return "Unauthorized";
+        case 403: return "Forbidden";
+        case 404: return "Not Found";
+        case 413: return "Payload Too Large";
+        case 500: return "Internal Server Error";
+        default:  return "";
+      }
+    }
+
+    void sendStatus( int code, const char* contentType, size_t contentLength )
+    {
+      char status[192];
+      char connection[64];
+
+      if ( _contentLength == CONTENT_LENGTH_NOT_SET )
+        _contentLength = contentLength;
+      _chunked = ( _contentLength == CONTENT_LENGTH_UNKNOWN );
+      //As ESP8266WebServer - a 1.0 client can't decode chunks, so it gets the body as-is ended by the close
+      if ( _chunked && _version == '0' )
+      {
+        _chunked = false;
+        _keepAlive = false;
+      }
+      if ( _keepAlive )
+        snprintf( connection, sizeof( connection ), "Connection: keep-alive\r\nKeep-Alive: timeout=%u\r\n", (unsigned int) ASYNC_KEEPALIVE_IDLE_S );
+      else
+        strcpy( connection, "Connection: close\r\n" );
+      if ( _chunked )
+        snprintf( status, sizeof( status ), "HTTP/1.%c %d %s\r\nContent-Type: %s\r\nTransfer-Encoding: chunked\r\n%s",
+                  _version, code, reason( code ), contentType, connection );
+      else if ( _contentLength == CONTENT_LENGTH_UNKNOWN )
+        snprintf( status, sizeof( status ), "HTTP/1.%c %d %s\r\nContent-Type: %s\r\n%s",
+                  _version, code, reason( code ), contentType, connection );
+      else
+        snprintf( status, sizeof( status ), "HTTP/1.%c %d %s\r\nContent-Type: %s\r\nContent-Length: %u\r\n%s",
+                  _version, code, reason( code ), contentType, (unsigned int) _contentLength, connection );
+      write( status, strlen( status ) );
+      write( _headers, strlen( _headers ) );
+      write( "\r\n", 2 );
+      _started = true;
+    }
+
+    //Queue data on the connection, waiting for acks only when the send buffer is full.
+    //The time allowed runs from the start of the response, not from the last ack, so a slow client can't hold loop().
+    void write( const char* data, size_t len )
+    {
+      while ( len > 0 && !_writeFailed && _current != nullptr && _current->client != nullptr )
+      {
+        AsyncClient* c = _current->client;
+        size_t space = c->space();
+        if ( space == 0 )
+        {
+          c->send();
+          if ( ( millis() - _writeStart ) >= ASYNC_WRITE_TIMEOUT_MS )
+          {
+            DEBUG_ESP( "AsyncWebServerAdapter: write timed out - dropping the connection\n" );
+            //Anything still to come for this response is discarded
+            _writeFailed = true;
+            _keepAlive = false;
+            c->close( true );
+            return;
+          }
+          //Lets the stack take in acks - and the other connections' data
+          delay( 1 );
+          continue;
+        }
+        size_t n = c->add( data, ( len < space ) ? len : space );
+        data += n;
+        len -= n;
+      }
+    }
+};
+
+typedef AsyncWebServerAdapter WebServerType;
+#endif //USE_ASYNC_SERVER
+
+#endif
@@ -16,7 +16,11 @@ unsigned int transactionId;
 int connectionCtr = 0; //variable to count number of times something has connected compared to disconnected. 
 unsigned int connected = (unsigned int) 0; //NOT_CONNECTED;
 #define ALPACA_DISCOVERY_PORT 32227
+#define ALPACA_HTTP_PORT 80
+#define UPDATE_SERVER_PORT 8080 //Firmware updates, when built with USE_ASYNC_SERVER
 int udpPort = ALPACA_DISCOVERY_PORT;
+//Bumped on every change to anything /status or /setup/config report - their ETag is made from it
+uint32_t stateGeneration = 0;
 static const char* PROGMEM DriverName = "Skybadger.ESPSwitch";
 static const char* PROGMEM DriverVersion = "0.0.1";
 static const char* PROGMEM DriverInfo = "Skybadger.ESPSwitch RESTful native device. ";
@@ -55,29 +59,34 @@ const String switchTypes[] = {"Relay_NO", "Relay_NC", "PWM", "DAC","Not Selected
 const int switchTypesLen = 5;
 enum SwitchType { SWITCH_RELAY_NO, SWITCH_RELAY_NC, SWITCH_PWM, SWITCH_ANALG_DAC, SWITCH_NOT_SELECTED };
 
+#define DEFAULT_NUM_SWITCHES 4;
+const int defaultNumSwitches = DEFAULT_NUM_SWITCHES;
+//Define the maximum number of switches supported - limited by memory really 
+const int MAXSWITCH = 16;
+const int MAX_NAME_LENGTH = 40;
+
 /*
  Typical values for PWM And ADC are 0 - 1024/1024, PWM in terms of fraction of the wave is high 
  and DAC in terms of the output voltage as a fraction of Vcc. 
+ The switches live in a fixed table of MAXSWITCH entries (numSwitches of them in use) with the names held inline, 
+ so there is nothing to allocate or free when the number of switches changes. 
+ The fields read on every api call are kept together at the front. 
  */
-
 typedef struct 
 {
-  char* description = nullptr;
-  char* switchName = nullptr;
-  enum SwitchType type = SWITCH_RELAY_NO;
-  int pin = -1; //Use for DAC and PWM outputs
-  bool writeable = true;       //Flag - can a user change this after initial setup 
+  float value = 0.0F;
+  uint8_t type = SWITCH_RELAY_NO; //enum SwitchType
+  int8_t pin = -1;                //Use for DAC and PWM outputs
+  bool writeable = true;          //Flag - can a user change this after initial setup 
   float min = 0.0;
   float max = 1.0;
   float step = 1.0;
-  float value = 0.0F;
+  char switchName[MAX_NAME_LENGTH] = "";
+  char description[MAX_NAME_LENGTH] = "";
 } SwitchEntry;
 
-#define DEFAULT_NUM_SWITCHES 4;
-const int defaultNumSwitches = DEFAULT_NUM_SWITCHES;
-//Define the maximum number of switches supported - limited by memory really 
-const int MAXSWITCH = 16;
-const int MAX_NAME_LENGTH = 40;
+//Called after any switch value is changed - defined in the sketch
+void onSwitchValueChanged( int id );
 
 //define the max resolution available to control a DAC or PWM
 const int MAX_DIGITAL_STEPS = 1024; //Limited by PWM resolution
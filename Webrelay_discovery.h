@@ -0,0 +1,101 @@
+/*
+File to define the ALPACA UDP discovery responder for the ASCOM switch web driver.
+A chooser broadcasts "alpacadiscovery1" to the discovery port and every device answers with the port its api is on.
+The answer only changes with the settings, so it is built once by beginDiscovery() - at startup and whenever the
+discovery port changes, which also rebinds the socket so the new port works without a restart.
+
+serviceDiscovery() runs every loop pass. When nothing has arrived it costs one parsePacket() call. Otherwise it answers
+up to DISCOVERY_BUDGET datagrams in the pass, leaving the rest for the next, and answers any one source at most once
+per DISCOVERY_MIN_INTERVAL_MS - a chooser retrying or sending on every interface gets its answer, but a flood of
+requests can't take over the loop from the relays and web server.
+*/
+#ifndef _WEBRELAY_DISCOVERY_H_
+#define _WEBRELAY_DISCOVERY_H_
+
+#include "Webrelay_common.h"
+#include "Webrelay_json.h"
+#include <WiFiUdp.h>
+
+const char DISCOVERY_REQUEST[] = "alpacadiscovery1";
+const size_t DISCOVERY_REQUEST_LENGTH = sizeof( DISCOVERY_REQUEST ) - 1;
+const int DISCOVERY_BUDGET = 4;
+const int DISCOVERY_SOURCES = 4;
+const unsigned long DISCOVERY_MIN_INTERVAL_MS = 500;
+
+typedef struct
+{
+  uint32_t address;
+  unsigned long lastReplyMs;
+} DiscoverySource;
+
+char discoveryReply[32];
+size_t discoveryReplyLength = 0;
+DiscoverySource discoverySources[ DISCOVERY_SOURCES ];
+
+//definitions
+void beginDiscovery( void );
+void serviceDiscovery( void );
+
+/*
+ * Build the reply and (re)bind the discovery port - call at startup and whenever udpPort changes.
+ */
+void beginDiscovery( void )
+{
+  JsonWriter writer( discoveryReply, sizeof( discoveryReply ) );
+
+  writer.beginObject();
+  writer.add( "AlpacaPort", ALPACA_HTTP_PORT );
+  writer.endObject();
+  discoveryReplyLength = writer.length();
+
+  Udp.stop();
+  Udp.begin( udpPort );
+  DEBUG_ESP( "beginDiscovery: listening on port %d\n", udpPort );
+}
+
+//Returns false if this source had a reply too recently. Sources beyond the table replace the least recent.
+bool discoveryAllowed( uint32_t address, unsigned long now )
+{
+  int oldest = 0;
+
+  for ( int i = 0; i < DISCOVERY_SOURCES; i++ )
+  {
+    DiscoverySource& source = discoverySources[i];
+    if ( source.address == address )
+    {
+      if ( ( now - source.lastReplyMs ) < DISCOVERY_MIN_INTERVAL_MS )
+        return false;
+      source.lastReplyMs = now;
+      return true;
+    }
+    if ( ( now - source.lastReplyMs ) > ( now - discoverySources[oldest].lastReplyMs ) )
+      oldest = i;
+  }
+  discoverySources[oldest].address = address;
+  discoverySources[oldest].lastReplyMs = now;
+  return true;
+}
+
+/*
+ * Call every pass of the loop.
+ */
+void serviceDiscovery( void )
+{
+  char request[ DISCOVERY_REQUEST_LENGTH ];
+  int handled = 0;
+
+  //parsePacket() drops whatever is left of the previous datagram
+  while ( handled < DISCOVERY_BUDGET && Udp.parsePacket() > 0 )
+  {
+    handled++;
+    if ( Udp.read( request, DISCOVERY_REQUEST_LENGTH ) != (int) DISCOVERY_REQUEST_LENGTH ||
+         memcmp( request, DISCOVERY_REQUEST, DISCOVERY_REQUEST_LENGTH ) != 0 )
+      continue;
+    if ( !discoveryAllowed( (uint32_t) Udp.remoteIP(), millis() ) )
+      continue;
+    Udp.beginPacket( Udp.remoteIP(), Udp.remotePort() );
+    Udp.write( (const uint8_t*) discoveryReply, discoveryReplyLength );
+    Udp.endPacket();
+  }
+}
+#endif
@@ -1,5 +1,19 @@
 /*
 File to define the eeprom variable save/restor operations for the ASCOM switch web driver
+
+Layout, version EEPROM_VERSION:
+  0                     EepromHeader           - magic, layout version and switch record size
+  EEPROM_CONFIG_ADDR    EepromConfig           - switch count, discovery port, hostname and location
+  EEPROM_SWITCH_ADDR    EepromSwitch[MAXSWITCH] - one fixed slot per switch
+Every record carries a CRC of its contents. A header that doesn't match - which includes the old single magic byte
+layout - means starting again from defaults, a bad record just loses that record to its defaults.
+Switch values changed in use are kept in the journal (Webrelay_journal.h), which is replayed over the values loaded here.
+
+Changes are marked with markConfigDirty()/markSwitchDirty() and saveToEeprom() writes only the marked records
+into the EEPROM buffer, so a name change doesn't re-serialise every switch. Nothing is committed if nothing is marked.
+Handlers only mark - serviceEeprom() in loop() does the save once there have been no changes for EEPROM_COMMIT_DELAY,
+so a run of edits from the setup page costs one commit and the responses don't wait for the flash.
+Anything about to restart the device must call saveToEeprom() first.
 */
 #ifndef _WEBRELAY_EEPROM_H_
 #define _WEBRELAY_EEPROM_H_
@@ -8,13 +22,71 @@ File to define the eeprom variable save/restor operations for the ASCOM switch w
 #include "DebugSerial.h"
 #include "eeprom.h"
 #include "EEPROMAnything.h"
+#include "Webrelay_journal.h"
+#include <coredecls.h> //crc32()
+
+const uint32_t EEPROM_MAGIC = 0x57534253UL; //'SBSW'
+const uint16_t EEPROM_VERSION = 2;
+
+typedef struct
+{
+  uint32_t magic;
+  uint16_t version;
+  uint16_t switchRecordSize;
+  uint32_t crc;
+} EepromHeader;
+
+typedef struct
+{
+  int16_t numSwitches;
+  uint16_t udpPort;
+  char hostname[MAX_NAME_LENGTH];
+  char location[MAX_NAME_LENGTH];
+  uint32_t crc;
+} EepromConfig;
+
+typedef struct
+{
+  uint8_t type;
+  int8_t pin;
+  uint8_t writeable;
+  uint8_t reserved;
+  float min;
+  float max;
+  float step;
+  float value;
+  char switchName[MAX_NAME_LENGTH];
+  char description[MAX_NAME_LENGTH];
+  uint32_t crc;
+} EepromSwitch;
 
-static const byte magic = '*';
+//No padding so the layout doesn't depend on the compiler
+static_assert( sizeof( EepromHeader ) == 12, "EepromHeader layout changed" );
+static_assert( sizeof( EepromConfig ) == 4 + 2 * MAX_NAME_LENGTH + 4, "EepromConfig layout changed" );
+static_assert( sizeof( EepromSwitch ) == 20 + 2 * MAX_NAME_LENGTH + 4, "EepromSwitch layout changed" );
+
+const int EEPROM_CONFIG_ADDR = sizeof( EepromHeader );
+const int EEPROM_SWITCH_ADDR = EEPROM_CONFIG_ADDR + sizeof( EepromConfig );
+const int eepromSize = EEPROM_SWITCH_ADDR + MAXSWITCH * sizeof( EepromSwitch );
+
+//Dirty record flags - one per switch from bit 0, then the config and header records
+const uint32_t EEPROM_DIRTY_CONFIG = 1UL << MAXSWITCH;
+const uint32_t EEPROM_DIRTY_HEADER = 1UL << ( MAXSWITCH + 1 );
+uint32_t eepromDirty = 0;
+const unsigned long EEPROM_COMMIT_DELAY = 3000; //ms with no further changes before committing
+unsigned long eepromLastChange = 0;
 
 //definitions
 void setDefaults(void );
+void markConfigDirty( void );
+void markSwitchDirty( int id );
+void markAllDirty( void );
 void saveToEeprom(void);
+void serviceEeprom( void );
 void setupFromEeprom(void);
+void dumpEeprom( void );
+
+#define EEPROM_RECORD_CRC( rec ) crc32( &(rec), offsetof( __typeof__( rec ), crc ) )
 
 /*
  * Write default values into variables - don't save yet. 
@@ -42,36 +114,20 @@ void setDefaults( void )
   Location = (char*) calloc( MAX_NAME_LENGTH, sizeof( char)  );       
   strcpy( Location, "Default Location" ); 
   
-  //Allocate storage for Number of Switch settings
   numSwitches = defaultNumSwitches;
   
-  //Create array of pointers to switchEntry descriptor blocks
-  switchEntry = (SwitchEntry**) calloc( sizeof( SwitchEntry* ), numSwitches );
-  
-  //Create individual descriptor blocks
-  for ( i=0; i< numSwitches ; i++ )
-  {
-    switchEntry[i] = (SwitchEntry*) calloc( sizeof( SwitchEntry ), 1 );
-  }
-  
   for ( i=0; i< numSwitches ; i++ )
   {
-    String tempName = "Switch_";
-
-    switchEntry[i]->description = (char*) calloc( MAX_NAME_LENGTH, sizeof(char) );
-    strcpy( switchEntry[i]->description, "Default description" );
-
-    tempName.concat( i );
-    switchEntry[i]->switchName = (char*) calloc( MAX_NAME_LENGTH, sizeof(char) );
-    strcpy( switchEntry[i]->switchName, tempName.c_str() );
-
-    switchEntry[i]->writeable = true;    
-    switchEntry[i]->type = SWITCH_RELAY_NO;
-    switchEntry[i]->pin = 0;
-    switchEntry[i]->min = 0.0F;
-    switchEntry[i]->max = 1.0F;
-    switchEntry[i]->step = 1.0F;
-    switchEntry[i]->value = 0.0F;
+    strcpy( switchEntry[i].description, "Default description" );
+    snprintf( switchEntry[i].switchName, MAX_NAME_LENGTH, "Switch_%d", i );
+
+    switchEntry[i].writeable = true;    
+    switchEntry[i].type = SWITCH_RELAY_NO;
+    switchEntry[i].pin = 0;
+    switchEntry[i].min = 0.0F;
+    switchEntry[i].max = 1.0F;
+    switchEntry[i].step = 1.0F;
+    switchEntry[i].value = 0.0F;
   }
 
 #if defined DEBUG_ESP_MH
@@ -83,206 +139,220 @@ void setDefaults( void )
   {
     String output;
     Serial.printf( "Switch %i: \n" , i) ;
-    Serial.printf( "Desc:      %s \n" , switchEntry[i]->description );
-    Serial.printf( "Name:      %s \n" , switchEntry[i]->switchName );  
-    Serial.printf( "Type:      %i \n", switchEntry[i]->type );
-    Serial.printf( "Pin:       %i \n", switchEntry[i]->pin );
-    Serial.printf( "Min:       %2.2f \n", switchEntry[i]->min );
-    Serial.printf( "Max:       %2.2f \n", switchEntry[i]->max );
-    Serial.printf( "Step:      %2.2f \n", switchEntry[i]->step );
-    Serial.printf( "Value:     %2.2f \n", switchEntry[i]->value );
-    Serial.printf( "Writeable: %i \n", switchEntry[i]->writeable );     
+    Serial.printf( "Desc:      %s \n" , switchEntry[i].description );
+    Serial.printf( "Name:      %s \n" , switchEntry[i].switchName );  
+    Serial.printf( "Type:      %i \n", switchEntry[i].type );
+    Serial.printf( "Pin:       %i \n", switchEntry[i].pin );
+    Serial.printf( "Min:       %2.2f \n", switchEntry[i].min );
+    Serial.printf( "Max:       %2.2f \n", switchEntry[i].max );
+    Serial.printf( "Step:      %2.2f \n", switchEntry[i].step );
+    Serial.printf( "Value:     %2.2f \n", switchEntry[i].value );
+    Serial.printf( "Writeable: %i \n", switchEntry[i].writeable );     
   }
 #endif
   DEBUGSL1( "setDefaults: exiting" );
 }
 
+void markConfigDirty( void )
+{
+  stateGeneration++;
+  eepromDirty |= EEPROM_DIRTY_CONFIG;
+  eepromLastChange = millis();
+}
+
+void markSwitchDirty( int id )
+{
+  stateGeneration++;
+  if ( id >= 0 && id < MAXSWITCH )
+    eepromDirty |= ( 1UL << id );
+  eepromLastChange = millis();
+}
+
+void markAllDirty( void )
+{
+  stateGeneration++;
+  eepromDirty = EEPROM_DIRTY_HEADER | EEPROM_DIRTY_CONFIG | ( ( 1UL << numSwitches ) - 1 );
+  eepromLastChange = millis();
+}
+
+/*
+ * Called from loop() - commit the marked records once the changes have stopped for a while.
+ */
+void serviceEeprom( void )
+{
+  if ( eepromDirty != 0 && ( millis() - eepromLastChange ) >= EEPROM_COMMIT_DELAY )
+  {
+    saveToEeprom();
+    //On failure wait another period before retrying rather than every pass
+    eepromLastChange = millis();
+  }
+}
+
 /*
- * Save current variables of interest into EEPROM
+ * Save the changed records into EEPROM
  */
 void saveToEeprom( void )
 {
-  int eepromAddr = 0;
+  int i = 0;
   DEBUGSL1( "savetoEeprom: Entered ");
-   
-  //Num Switches
-  EEPROMWriteAnything( eepromAddr = 4, numSwitches );
-  eepromAddr += sizeof(int);  
-  DEBUGS1( "Written numSwitches: ");DEBUGSL1( numSwitches );
-  
-  //UDP Port
-  EEPROMWriteAnything( eepromAddr, udpPort );
-  eepromAddr += sizeof(int);  
-  DEBUGS1( "Written udpPort: ");DEBUGSL1( udpPort );
-
-  //hostname
-  EEPROMWriteString( eepromAddr, myHostname, MAX_NAME_LENGTH );
-  eepromAddr += MAX_NAME_LENGTH;   
-  DEBUGS1( "Written hostname: ");DEBUGSL1( myHostname );
-
-  //Mgmt Location
-  EEPROMWriteString( eepromAddr, Location, MAX_NAME_LENGTH );
-  eepromAddr += MAX_NAME_LENGTH;   
-  DEBUGS1( "Written Location: ");DEBUGSL1( Location );
-  
-  //Switch state
-  for ( int i = 0; i< numSwitches; i++ )
+
+  if ( eepromDirty == 0 )
+    return;
+
+  if ( eepromDirty & EEPROM_DIRTY_HEADER )
   {
-    EEPROMWriteAnything( eepromAddr, (int) switchEntry[i]->type );
-    eepromAddr += sizeof( (int) switchEntry[i]->type );    
-    
-    EEPROMWriteAnything( eepromAddr, (int) switchEntry[i]->pin );
-    eepromAddr += sizeof( (int) switchEntry[i]->pin );    
-    
-    EEPROMWriteAnything( eepromAddr, (bool) switchEntry[i]->writeable );
-    eepromAddr += sizeof( (bool) switchEntry[i]->writeable );    
-    
-    EEPROMWriteAnything( eepromAddr, (float) switchEntry[i]->min );
-    eepromAddr += sizeof( (float) switchEntry[i]->min );
-    
-    EEPROMWriteAnything( eepromAddr, (float) switchEntry[i]->max );
-    eepromAddr += sizeof( (float) switchEntry[i]->max );
-    
-    EEPROMWriteAnything( eepromAddr, (float) switchEntry[i]->step );
-    eepromAddr += sizeof( (float) switchEntry[i]->step );
-    
-    EEPROMWriteAnything( eepromAddr, (float) switchEntry[i]->value );
-    eepromAddr += sizeof( (float) switchEntry[i]->value );
-    
-    //Name
-    EEPROMWriteString( eepromAddr, switchEntry[i]->switchName, MAX_NAME_LENGTH );
-    eepromAddr += (MAX_NAME_LENGTH * sizeof( char));    
-    
-    //Description
-    EEPROMWriteString( eepromAddr, switchEntry[i]->description, MAX_NAME_LENGTH );
-    eepromAddr += (MAX_NAME_LENGTH * sizeof( char));    
+    EepromHeader header;
+    header.magic = EEPROM_MAGIC;
+    header.version = EEPROM_VERSION;
+    header.switchRecordSize = sizeof( EepromSwitch );
+    header.crc = EEPROM_RECORD_CRC( header );
+    EEPROM.put( 0, header );
+    DEBUGSL1( "Written header" );
   }
 
-  //Magic number write for data write complete. 
-  EEPROM.put( 0, magic );
-  EEPROM.commit();
-  DEBUGS1( "Wrote ");DEBUGS1(eepromAddr);DEBUGSL1( " bytes ");
-   
-  //Test readback of contents
-  String input = "";
-  char ch;
-  int eepromReadLength = 4 + (numSwitches * MAX_NAME_LENGTH * 3) + (2* sizeof(int) )  + ( numSwitches * ( sizeof(SwitchEntry) + (2*MAX_NAME_LENGTH) ) ) + 10;
-  for ( int i = 0; i < eepromReadLength ; i++ )
+  if ( eepromDirty & EEPROM_DIRTY_CONFIG )
   {
-    ch = (char) EEPROM.read( i );
-    if ( ch == '\0' )
-      ch = '~';
-    if ( (i % 32 ) == 0 )
-      input.concat( "\n\r" );
-    input.concat( ch );
+    EepromConfig config;
+    memset( &config, 0, sizeof( config ) );
+    config.numSwitches = numSwitches;
+    config.udpPort = udpPort;
+    strncpy( config.hostname, myHostname, MAX_NAME_LENGTH - 1 );
+    strncpy( config.location, Location, MAX_NAME_LENGTH - 1 );
+    config.crc = EEPROM_RECORD_CRC( config );
+    EEPROM.put( EEPROM_CONFIG_ADDR, config );
+    DEBUGS1( "Written config, numSwitches: ");DEBUGSL1( numSwitches );
   }
-  
-  Serial.printf( "EEPROM contents after: \n %s \n", input.c_str() );
+
+  for ( i = 0; i < numSwitches; i++ )
+  {
+    if ( !( eepromDirty & ( 1UL << i ) ) )
+      continue;
+
+    EepromSwitch rec;
+    memset( &rec, 0, sizeof( rec ) );
+    rec.type = switchEntry[i].type;
+    rec.pin = switchEntry[i].pin;
+    rec.writeable = switchEntry[i].writeable;
+    rec.min = switchEntry[i].min;
+    rec.max = switchEntry[i].max;
+    rec.step = switchEntry[i].step;
+    rec.value = switchEntry[i].value;
+    strncpy( rec.switchName, switchEntry[i].switchName, MAX_NAME_LENGTH - 1 );
+    strncpy( rec.description, switchEntry[i].description, MAX_NAME_LENGTH - 1 );
+    rec.crc = EEPROM_RECORD_CRC( rec );
+    EEPROM.put( EEPROM_SWITCH_ADDR + i * sizeof( EepromSwitch ), rec );
+    DEBUGS1( "Written switch: ");DEBUGSL1( i );
+  }
+
+  if ( EEPROM.commit() )
+    eepromDirty = 0;
+  else
+    DEBUGSL1( "saveToEeprom: commit failed - will retry on next save" );
   DEBUGSL1( "saveToEeprom: exiting ");
 }
 
 void setupFromEeprom( void )
 {
-  int eepromAddr = 0;
   int i = 0;
+  EepromHeader header;
+  EepromConfig config;
     
   DEBUGSL1( "setUpFromEeprom: Entering ");
-  byte myMagic = '\0';
-  //Setup internal variables - read from EEPROM.
-  myMagic = EEPROM.read( 0 );
-  DEBUGS1( "Read magic: ");DEBUGSL1( (char) myMagic );
-  
-  if ( (byte) myMagic != magic ) //initialise eeprom for first time use. 
+
+  //Start from defaults and overlay each record that checks out
+  setDefaults();
+
+  EEPROM.get( 0, header );
+  if ( header.magic != EEPROM_MAGIC || header.version != EEPROM_VERSION || 
+       header.switchRecordSize != sizeof( EepromSwitch ) || header.crc != EEPROM_RECORD_CRC( header ) )
   {
-    setDefaults();
+    //initialise eeprom for first time use or after a layout change.
+    markAllDirty();
     saveToEeprom();
-    DEBUGSL1( "Failed to find init magic byte - wrote defaults & restarted.");
+    DEBUGS1( "EEPROM header not recognised, version: ");DEBUGS1( header.version );DEBUGSL1( " - wrote defaults & restarted.");
     device.restart();
     return;
   }    
-    
-  //Num Switches 
-  EEPROMReadAnything( eepromAddr = 4, numSwitches );
-  eepromAddr  += sizeof(int);
-  DEBUGS1( "Read numSwitches: ");DEBUGSL1( numSwitches );
-  
-  //UDP port 
-  EEPROMReadAnything( eepromAddr, udpPort );
-  eepromAddr  += sizeof(int);  
-  DEBUGS1( "Read UDPport: ");DEBUGSL1( udpPort );
-
-  //hostname - directly into variable array 
-  if( myHostname != nullptr )
-    free( myHostname );
-  myHostname = (char*) calloc( MAX_NAME_LENGTH, sizeof( char ) );  
-  EEPROMReadString( eepromAddr, myHostname, MAX_NAME_LENGTH );
-  eepromAddr  += MAX_NAME_LENGTH * sizeof(char);  
-  DEBUGS1( "Read hostname: ");DEBUGSL1( myHostname );
-
-  //Setup MQTT client id based on hostname
-  if ( thisID != nullptr ) 
-     free ( thisID );
-  thisID = (char*) calloc( MAX_NAME_LENGTH, sizeof( char)  );       
-  strcpy ( thisID, myHostname );
-  DEBUGS1( "Read MQTT ID: ");DEBUGSL1( thisID );
-  
-  if( Location != nullptr )
-    free( Location );
-  Location = (char*) calloc( MAX_NAME_LENGTH, sizeof( char ) );  
-  EEPROMReadString( eepromAddr, Location, MAX_NAME_LENGTH );
-  eepromAddr  += MAX_NAME_LENGTH * sizeof(char);  
-  DEBUGS1( "Read Location: ");DEBUGSL1( Location );
-
-  //free old switch entries
-  if ( switchEntry != nullptr )
+
+  EEPROM.get( EEPROM_CONFIG_ADDR, config );
+  if ( config.crc == EEPROM_RECORD_CRC( config ) && config.numSwitches >= 1 && config.numSwitches <= MAXSWITCH )
   {
-     for ( i= 0; i < numSwitches; i++ )
-        if( switchEntry[i] != nullptr ) 
-          free ( switchEntry[i] );
-     free( switchEntry);
+    numSwitches = config.numSwitches;
+    udpPort = config.udpPort;
+    config.hostname[ MAX_NAME_LENGTH - 1 ] = '\0';
+    config.location[ MAX_NAME_LENGTH - 1 ] = '\0';
+    strcpy( myHostname, config.hostname );
+    strcpy( Location, config.location );
+    //Setup MQTT client id based on hostname
+    strcpy( thisID, myHostname );
+    DEBUGS1( "Read numSwitches: ");DEBUGSL1( numSwitches );
+    DEBUGS1( "Read UDPport: ");DEBUGSL1( udpPort );
+    DEBUGS1( "Read hostname: ");DEBUGSL1( myHostname );
+    DEBUGS1( "Read Location: ");DEBUGSL1( Location );
   }
-  
-  //Create new
-  switchEntry = (SwitchEntry**) calloc ( sizeof (SwitchEntry*), numSwitches );
+  else
+  {
+    DEBUGSL1( "setupFromEeprom: config record failed CRC - using defaults" );
+    markConfigDirty();
+  }
+
   for ( i=0; i< numSwitches; i++ )
   {
-    switchEntry[i] = (SwitchEntry*) calloc( sizeof( SwitchEntry ), 1 );
-    if( switchEntry[i] == nullptr )
+    EepromSwitch rec;
+    EEPROM.get( EEPROM_SWITCH_ADDR + i * sizeof( EepromSwitch ), rec );
+    if ( rec.crc != EEPROM_RECORD_CRC( rec ) )
     {
-      //something has gone wrong - probably run out of memory space. 
-      //Alert somehow .       
-      break;
+      DEBUGS1( "setupFromEeprom: switch record failed CRC - using defaults for ");DEBUGSL1( i );
+      //Slots beyond the previous default count were never initialised by setDefaults
+      snprintf( switchEntry[i].switchName, MAX_NAME_LENGTH, "Switch_%d", i );
+      strcpy( switchEntry[i].description, "Default description" );
+      markSwitchDirty( i );
+      continue;
     }
-    EEPROMReadAnything( eepromAddr, switchEntry[i]->type );
-    eepromAddr += sizeof( switchEntry[i]->type );
-    
-    EEPROMReadAnything( eepromAddr, switchEntry[i]->pin );
-    eepromAddr += sizeof( switchEntry[i]->pin );
-    
-    EEPROMReadAnything( eepromAddr, switchEntry[i]->writeable );
-    eepromAddr += sizeof( switchEntry[i]->writeable );    
-    
-    EEPROMReadAnything( eepromAddr, switchEntry[i]->min );
-    eepromAddr += sizeof( switchEntry[i]->min );
-    
-    EEPROMReadAnything( eepromAddr, switchEntry[i]->max );
-    eepromAddr += sizeof( switchEntry[i]->max );
-    
-    EEPROMReadAnything( eepromAddr, switchEntry[i]->step );
-    eepromAddr += sizeof( switchEntry[i]->step );
-    
-    EEPROMReadAnything( eepromAddr, switchEntry[i]->value );
-    eepromAddr += sizeof( switchEntry[i]->value );
-    
-    switchEntry[i]->switchName = (char*) calloc( MAX_NAME_LENGTH, sizeof( char ) );  
-    EEPROMReadString( eepromAddr, switchEntry[i]->switchName, MAX_NAME_LENGTH );
-    eepromAddr += MAX_NAME_LENGTH * sizeof( char);    
+    switchEntry[i].type = rec.type;
+    switchEntry[i].pin = rec.pin;
+    switchEntry[i].writeable = rec.writeable;
+    switchEntry[i].min = rec.min;
+    switchEntry[i].max = rec.max;
+    switchEntry[i].step = rec.step;
+    switchEntry[i].value = rec.value;
+    rec.switchName[ MAX_NAME_LENGTH - 1 ] = '\0';
+    rec.description[ MAX_NAME_LENGTH - 1 ] = '\0';
+    strcpy( switchEntry[i].switchName, rec.switchName );
+    strcpy( switchEntry[i].description, rec.description );
+  }
 
-    switchEntry[i]->description = (char*) calloc( MAX_NAME_LENGTH, sizeof( char ) );  
-    EEPROMReadString( eepromAddr, switchEntry[i]->description, MAX_NAME_LENGTH );
-    eepromAddr += MAX_NAME_LENGTH * sizeof( char);    
-  }  
+  //Latest switch values
+  journalBegin();
+  journalReplay();
 
+  //Repair any records that failed
+  saveToEeprom();
+#if defined DEBUG_ESP_MH
+  dumpEeprom();
+#endif
   DEBUGSL1( "setupFromEeprom: exiting" );
 }
+
+/*
+ * Debug readback of the EEPROM buffer - not on the save path. 
+ */
+void dumpEeprom( void )
+{
+  int i = 0;
+  int len = EEPROM_SWITCH_ADDR + numSwitches * sizeof( EepromSwitch );
+  char line[33];
+
+  Serial.printf( "EEPROM contents, %d bytes: \n", len );
+  for ( i = 0; i < len; i++ )
+  {
+    char ch = (char) EEPROM.read( i );
+    line[ i % 32 ] = ( ch >= 0x20 && ch < 0x7F ) ? ch : '~';
+    if ( ( i % 32 ) == 31 || i == len - 1 )
+    {
+      line[ ( i % 32 ) + 1 ] = '\0';
+      Serial.printf( "%04x %s\n", i - ( i % 32 ), line );
+    }
+  }
+}
 #endif
@@ -0,0 +1,219 @@
+/*
+File to define the switch state journal for the ASCOM switch web driver.
+Switch values change far more often than the configuration, so rather than re-committing the EEPROM sector each time
+a value changes, each change is appended as an 8 byte record to a journal in raw flash and the journal is replayed
+over the EEPROM values at boot.
+
+The journal uses the last two sectors of the filesystem area of the flash layout (this sketch doesn't mount a
+filesystem). Records are appended to one sector until it is full, then the other is erased and starts with a snapshot
+of every switch before taking new records - so one erase per ~500 changes, alternating between the two sectors.
+Replay reads the older sector then the newer one, so a snapshot interrupted by a reset still leaves the full
+history of the older sector to fall back on. A record cut short by a reset fails its check byte and is skipped.
+
+If the flash layout has no filesystem area the journal is disabled and values persist only with the EEPROM records.
+*/
+#ifndef _WEBRELAY_JOURNAL_H_
+#define _WEBRELAY_JOURNAL_H_
+
+#include "Webrelay_common.h"
+#include <spi_flash.h>
+
+extern "C" uint32_t _FS_start;
+extern "C" uint32_t _FS_end;
+
+const uint32_t JOURNAL_SECTORS = 2;
+const uint32_t JOURNAL_ERASED = 0xFFFFFFFFUL;
+
+typedef struct
+{
+  uint16_t seq;   //Increments per record, across both sectors
+  uint8_t id;     //Switch number
+  uint8_t check;  //Over the other fields - catches a record cut short by a reset
+  float value;
+} JournalRecord;
+static_assert( sizeof( JournalRecord ) == 8, "JournalRecord must stay 8 bytes - flash writes are in words" );
+
+const int JOURNAL_RECORDS_PER_SECTOR = SPI_FLASH_SEC_SIZE / sizeof( JournalRecord );
+
+uint32_t journalBase = 0;      //Flash address of the first sector, 0 when disabled
+int journalSector = 0;         //Sector being appended to
+int journalNext = 0;           //Next free record in that sector
+uint16_t journalSeq = 0;
+float journalled[MAXSWITCH];   //Last value written per switch, to skip writes that change nothing
+
+//definitions
+bool journalBegin( void );
+void journalReplay( void );
+bool journalAppend( int id, float value );
+
+uint8_t journalCheck( JournalRecord& rec )
+{
+  const uint8_t* p = (const uint8_t*) &rec;
+  uint8_t check = 0x5A;
+  for ( int i = 0; i < (int) sizeof( JournalRecord ); i++ )
+  {
+    if ( i != (int) offsetof( JournalRecord, check ) )
+      check = ( ( check << 1 ) | ( check >> 7 ) ) ^ p[i];
+  }
+  return check;
+}
+
+uint32_t journalSectorAddr( int sector )
+{
+  return journalBase + sector * SPI_FLASH_SEC_SIZE;
+}
+
+bool journalRead( int sector, int index, JournalRecord& rec )
+{
+  return device.flashRead( journalSectorAddr( sector ) + index * sizeof( JournalRecord ), (uint32_t*) &rec, sizeof( rec ) );
+}
+
+bool journalIsErased( JournalRecord& rec )
+{
+  return ( ( (uint32_t*) &rec )[0] == JOURNAL_ERASED ) && ( ( (uint32_t*) &rec )[1] == JOURNAL_ERASED );
+}
+
+//Count of used records in a sector - stops at the first erased slot
+int journalUsed( int sector )
+{
+  JournalRecord rec;
+  int i = 0;
+  for ( i = 0; i < JOURNAL_RECORDS_PER_SECTOR; i++ )
+  {
+    if ( !journalRead( sector, i, rec ) || journalIsErased( rec ) )
+      break;
+  }
+  return i;
+}
+
+bool journalWrite( int id, float value )
+{
+  JournalRecord rec;
+  rec.seq = journalSeq;
+  rec.id = (uint8_t) id;
+  rec.value = value;
+  rec.check = journalCheck( rec );
+  if ( !device.flashWrite( journalSectorAddr( journalSector ) + journalNext * sizeof( JournalRecord ), (uint32_t*) &rec, sizeof( rec ) ) )
+    return false;
+  journalSeq++;
+  journalNext++;
+  journalled[id] = value;
+  return true;
+}
+
+/*
+ * Switch to the other sector - erase it and start it with the current value of every switch.
+ */
+bool journalCompact( void )
+{
+  int other = ( journalSector + 1 ) % JOURNAL_SECTORS;
+
+  DEBUGS1( "journalCompact: moving to sector " ); DEBUGSL1( other );
+  if ( !device.flashEraseSector( journalSectorAddr( other ) / SPI_FLASH_SEC_SIZE ) )
+    return false;
+  journalSector = other;
+  journalNext = 0;
+  for ( int i = 0; i < numSwitches; i++ )
+  {
+    if ( !journalWrite( i, switchEntry[i].value ) )
+      return false;
+  }
+  return true;
+}
+
+/*
+ * Find the journal sectors and where to append next. Returns false if there is nowhere to put the journal.
+ */
+bool journalBegin( void )
+{
+  uint32_t fsStart = (uint32_t) (uintptr_t) &_FS_start - 0x40200000UL;
+  uint32_t fsEnd = (uint32_t) (uintptr_t) &_FS_end - 0x40200000UL;
+  JournalRecord first[JOURNAL_SECTORS];
+  int newest = -1;
+  int i = 0;
+
+  journalBase = 0;
+  if ( fsEnd <= fsStart || fsEnd - fsStart < JOURNAL_SECTORS * SPI_FLASH_SEC_SIZE )
+  {
+    DEBUGSL1( "journalBegin: no filesystem area in the flash layout - switch state journal disabled" );
+    return false;
+  }
+  journalBase = fsEnd - JOURNAL_SECTORS * SPI_FLASH_SEC_SIZE;
+
+  //The sector whose first record is newest is the one being appended to
+  for ( i = 0; i < (int) JOURNAL_SECTORS; i++ )
+  {
+    if ( !journalRead( i, 0, first[i] ) || journalIsErased( first[i] ) || journalCheck( first[i] ) != first[i].check )
+      continue;
+    if ( newest < 0 || (int16_t) ( first[i].seq - first[newest].seq ) > 0 )
+      newest = i;
+  }
+
+  if ( newest < 0 )
+  {
+    //Fresh flash or left over from a filesystem - clear both so nothing stale is replayed
+    journalSector = JOURNAL_SECTORS - 1;
+    journalSeq = 0;
+    if ( !device.flashEraseSector( journalSectorAddr( journalSector ) / SPI_FLASH_SEC_SIZE ) )
+      return false;
+    return journalCompact();
+  }
+
+  journalSector = newest;
+  journalNext = journalUsed( newest );
+  journalSeq = first[newest].seq + journalNext;
+  DEBUGS1( "journalBegin: records in use " ); DEBUGSL1( journalNext );
+  return true;
+}
+
+/*
+ * Apply the journalled values over those loaded from the EEPROM - older sector first.
+ */
+void journalReplay( void )
+{
+  JournalRecord rec;
+  int order[JOURNAL_SECTORS];
+  int s = 0, i = 0;
+
+  for ( i = 0; i < MAXSWITCH; i++ )
+    journalled[i] = ( i < numSwitches ) ? switchEntry[i].value : 0.0F;
+  if ( journalBase == 0 )
+    return;
+
+  order[0] = ( journalSector + 1 ) % JOURNAL_SECTORS;
+  order[1] = journalSector;
+  for ( s = 0; s < (int) JOURNAL_SECTORS; s++ )
+  {
+    for ( i = 0; i < JOURNAL_RECORDS_PER_SECTOR; i++ )
+    {
+      if ( !journalRead( order[s], i, rec ) || journalIsErased( rec ) )
+        break;
+      if ( journalCheck( rec ) != rec.check || rec.id >= numSwitches )
+        continue;
+      switchEntry[rec.id].value = rec.value;
+      journalled[rec.id] = rec.value;
+    }
+  }
+}
+
+/*
+ * Record a new switch value. Values that haven't changed since the last record are not written.
+ */
+bool journalAppend( int id, float value )
+{
+  if ( journalBase == 0 || id < 0 || id >= MAXSWITCH )
+    return false;
+  if ( journalled[id] == value )
+    return true;
+
+  if ( journalNext >= JOURNAL_RECORDS_PER_SECTOR && !journalCompact() )
+  {
+    DEBUGSL1( "journalAppend: compaction failed" );
+    return false;
+  }
+  //The snapshot in compaction already carries the new value
+  if ( journalled[id] == value )
+    return true;
+  return journalWrite( id, value );
+}
+#endif
@@ -0,0 +1,330 @@
+/*
+File to define the allocation-free json writer and Alpaca response helpers for the ASCOM switch web driver.
+Responses are serialised straight into a fixed static buffer and sent from there, rather than via a DynamicJsonBuffer,
+a JsonObject and a String copy per request.
+A JsonWriter given a flush function streams - whenever the buffer fills it is passed on (e.g. as a chunk) and re-used.
+
+AlpacaResponse holds the standard fields until send time because handlers set the error fields after the value, but
+they are output in the position jsonResponseBuilder() gives them:
+  ClientTransactionID, ServerTransactionID, Name, ErrorNumber, ErrorMessage, then Value if one was set.
+Numbers are printed the way ArduinoJson v5 does - integral floats without a decimal point, others to 6 places with
+trailing zeros dropped.
+*/
+#ifndef _WEBRELAY_JSON_H_
+#define _WEBRELAY_JSON_H_
+
+#include "Webrelay_common.h"
+
+const int RESPONSE_BUFFER_SIZE = 512;
+const int MAX_ERROR_MESSAGE_LENGTH = 96;
+static char responseBuffer[ RESPONSE_BUFFER_SIZE ];
+
+typedef void (*JsonFlushFunction)( const char* data, size_t len );
+
+class JsonWriter
+{
+  public:
+    JsonWriter( char* buffer, size_t size, JsonFlushFunction flushFn = nullptr )
+      : _buf( buffer ), _size( size ), _len( 0 ), _depth( 0 ), _needComma( 0 ), _overflow( false ), _flushFn( flushFn ) {}
+
+    void beginObject( const char* key = nullptr )  { separator( key ); write( '{' ); push(); }
+    void endObject( void )                         { pop(); write( '}' ); }
+    void beginArray( const char* key = nullptr )   { separator( key ); write( '[' ); push(); }
+    void endArray( void )                          { pop(); write( ']' ); }
+
+    void add( const char* key, const char* value ) { separator( key ); writeString( value ); }
+    void add( const char* key, bool value )        { separator( key ); write( ( value ) ? "true" : "false" ); }
+    void add( const char* key, int value )         { add( key, (long) value ); }
+    void add( const char* key, unsigned int value ){ add( key, (unsigned long) value ); }
+    void add( const char* key, long value )
+    {
+      separator( key );
+      if ( value < 0 )
+      {
+        write( '-' );
+        writeUnsigned( (unsigned long) ( -value ) );
+      }
+      else
+        writeUnsigned( (unsigned long) value );
+    }
+    void add( const char* key, unsigned long value ) { separator( key ); writeUnsigned( value ); }
+    void add( const char* key, double value )      { separator( key ); writeDouble( value ); }
+    //Pre-serialised json value, written as-is
+    void addRaw( const char* key, const char* json ) { separator( key ); write( json ); }
+    //Key only, for a value written in later - returns the offset the value goes at. Not for a streaming writer.
+    size_t addSplice( const char* key ) { separator( key ); return _len; }
+
+    //Pass anything buffered to the flush function and start again at the front of the buffer.
+    void flush( void )
+    {
+      if ( _flushFn != nullptr && _len > 0 )
+        _flushFn( _buf, _len );
+      _len = 0;
+    }
+
+    const char* c_str( void ) { _buf[ ( _len < _size ) ? _len : _size - 1 ] = '\0'; return _buf; }
+    size_t length( void ) { return _len; }
+    bool overflowed( void ) { return _overflow; }
+
+  private:
+    char* _buf;
+    size_t _size;
+    size_t _len;
+    uint8_t _depth;
+    uint32_t _needComma; //One bit per nesting level
+    bool _overflow;
+    JsonFlushFunction _flushFn;
+
+    void push( void ) { _depth++; _needComma &= ~( 1UL << _depth ); }
+    void pop( void )  { if ( _depth > 0 ) _depth--; }
+
+    void separator( const char* key )
+    {
+      if ( _needComma & ( 1UL << _depth ) )
+        write( ',' );
+      _needComma |= ( 1UL << _depth );
+      if ( key != nullptr )
+      {
+        writeString( key );
+        write( ':' );
+      }
+    }
+
+    void write( char c )
+    {
+      //Keep one byte spare for the terminator
+      if ( _len >= _size - 1 )
+      {
+        if ( _flushFn == nullptr )
+        {
+          _overflow = true;
+          return;
+        }
+        flush();
+      }
+      _buf[ _len++ ] = c;
+    }
+
+    void write( const char* s )
+    {
+      while ( *s )
+        write( *s++ );
+    }
+
+    void writeString( const char* s )
+    {
+      write( '"' );
+      if ( s != nullptr )
+      {
+        for ( ; *s; s++ )
+        {
+          switch ( *s )
+          {
+            case '"':  write( '\\' ); write( '"' ); break;
+            case '\\': write( '\\' ); write( '\\' ); break;
+            case '\n': write( '\\' ); write( 'n' ); break;
+            case '\r': write( '\\' ); write( 'r' ); break;
+            case '\t': write( '\\' ); write( 't' ); break;
+            default:
+              if ( (uint8_t) *s >= 0x20 )
+                write( *s );
+              break;
+          }
+        }
+      }
+      write( '"' );
+    }
+
+    void writeUnsigned( unsigned long value )
+    {
+      char digits[12];
+      int i = 0;
+      do
+      {
+        digits[i++] = '0' + ( value % 10 );
+        value /= 10;
+      } while ( value > 0 );
+      while ( i > 0 )
+        write( digits[--i] );
+    }
+
+    void writeDouble( double value )
+    {
+      unsigned long integral = 0;
+      unsigned long decimals = 0;
+      int places = 6;
+      char digits[6];
+
+      if ( isnan( value ) || isinf( value ) )
+      {
+        write( "null" );
+        return;
+      }
+      if ( value < 0.0 )
+      {
+        write( '-' );
+        value = -value;
+      }
+      integral = (unsigned long) value;
+      decimals = (unsigned long) ( ( value - (double) integral ) * 1000000.0 + 0.5 );
+      if ( decimals >= 1000000UL )
+      {
+        integral++;
+        decimals -= 1000000UL;
+      }
+      writeUnsigned( integral );
+      if ( decimals == 0 )
+        return;
+
+      while ( decimals % 10 == 0 )
+      {
+        decimals /= 10;
+        places--;
+      }
+      for ( int i = places - 1; i >= 0; i-- )
+      {
+        digits[i] = '0' + ( decimals % 10 );
+        decimals /= 10;
+      }
+      write( '.' );
+      for ( int i = 0; i < places; i++ )
+        write( digits[i] );
+    }
+};
+
+enum AlpacaValueType { ALPACA_VALUE_NONE, ALPACA_VALUE_BOOL, ALPACA_VALUE_INT, ALPACA_VALUE_DOUBLE, ALPACA_VALUE_STRING };
+
+typedef struct
+{
+  uint32_t clientID;
+  uint32_t transID;
+  uint32_t serverTransID;
+  const char* name;
+  int errorNumber;
+  char errorMessage[ MAX_ERROR_MESSAGE_LENGTH ];
+  enum AlpacaValueType valueType;
+  union
+  {
+    bool b;
+    long i;
+    double d;
+    const char* s;
+  } value;
+} AlpacaResponse;
+
+//definitions
+void alpacaResponseBuilder( AlpacaResponse& resp, uint32_t clientID, uint32_t transID, uint32_t serverTransID, const char* name, int errNum, const char* errMsg );
+void alpacaError( AlpacaResponse& resp, int errNum, const char* errMsg );
+void alpacaWriteHeader( JsonWriter& writer, AlpacaResponse& resp );
+void alpacaWriteResponse( JsonWriter& writer, AlpacaResponse& resp );
+void sendAlpacaResponse( int returnCode, AlpacaResponse& resp );
+void sendJson( int returnCode, const char* json, size_t len );
+bool sendNotModified( void );
+void beginChunkedJson( int returnCode );
+void sendChunk( const char* data, size_t len );
+void endChunked( void );
+
+void alpacaResponseBuilder( AlpacaResponse& resp, uint32_t clientID, uint32_t transID, uint32_t serverTransID, const char* name, int errNum, const char* errMsg )
+{
+  resp.clientID = clientID;
+  resp.transID = transID;
+  resp.serverTransID = serverTransID;
+  resp.name = name;
+  resp.valueType = ALPACA_VALUE_NONE;
+  alpacaError( resp, errNum, errMsg );
+}
+
+void alpacaError( AlpacaResponse& resp, int errNum, const char* errMsg )
+{
+  resp.errorNumber = errNum;
+  strncpy( resp.errorMessage, errMsg, MAX_ERROR_MESSAGE_LENGTH - 1 );
+  resp.errorMessage[ MAX_ERROR_MESSAGE_LENGTH - 1 ] = '\0';
+}
+
+void alpacaValue( AlpacaResponse& resp, bool value )        { resp.valueType = ALPACA_VALUE_BOOL;   resp.value.b = value; }
+void alpacaValue( AlpacaResponse& resp, int value )         { resp.valueType = ALPACA_VALUE_INT;    resp.value.i = value; }
+void alpacaValue( AlpacaResponse& resp, double value )      { resp.valueType = ALPACA_VALUE_DOUBLE; resp.value.d = value; }
+void alpacaValue( AlpacaResponse& resp, const char* value ) { resp.valueType = ALPACA_VALUE_STRING; resp.value.s = value; }
+
+//Write the standard fields - the caller has already opened the object
+void alpacaWriteHeader( JsonWriter& writer, AlpacaResponse& resp )
+{
+  writer.add( "ClientTransactionID", (unsigned long) resp.transID );
+  writer.add( "ServerTransactionID", (unsigned long) resp.serverTransID );
+  writer.add( "Name", resp.name );
+  writer.add( "ErrorNumber", resp.errorNumber );
+  writer.add( "ErrorMessage", resp.errorMessage );
+}
+
+//Write the whole response object
+void alpacaWriteResponse( JsonWriter& writer, AlpacaResponse& resp )
+{
+  writer.beginObject();
+  alpacaWriteHeader( writer, resp );
+  switch ( resp.valueType )
+  {
+    case ALPACA_VALUE_BOOL:   writer.add( "Value", resp.value.b ); break;
+    case ALPACA_VALUE_INT:    writer.add( "Value", resp.value.i ); break;
+    case ALPACA_VALUE_DOUBLE: writer.add( "Value", resp.value.d ); break;
+    case ALPACA_VALUE_STRING: writer.add( "Value", resp.value.s ); break;
+    default: break;
+  }
+  writer.endObject();
+}
+
+void sendAlpacaResponse( int returnCode, AlpacaResponse& resp )
+{
+  JsonWriter writer( responseBuffer, sizeof( responseBuffer ) );
+
+  alpacaWriteResponse( writer, resp );
+  if ( writer.overflowed() )
+    DEBUGSL1( "sendAlpacaResponse: response truncated" );
+  sendJson( returnCode, writer.c_str(), writer.length() );
+}
+
+/*
+ * Transport - send from the buffer without taking a String copy.
+ */
+void sendJson( int returnCode, const char* json, size_t len )
+{
+  server.setContentLength( len );
+  server.send( returnCode, "application/json", "" );
+  server.sendContent( json, len );
+}
+
+/*
+ * Conditional GET for responses made from the device state. Adds an ETag from stateGeneration and the connected state
+ * to the response about to be sent and, if the client already holds that, sends 304 with no body and returns true.
+ * Anything that changes what such a response shows must bump stateGeneration.
+ */
+bool sendNotModified( void )
+{
+  char etag[24];
+
+  snprintf( etag, sizeof( etag ), "\"%08lx-%x\"", (unsigned long) stateGeneration, connected );
+  server.sendHeader( F("ETag"), etag );
+  server.sendHeader( F("Cache-Control"), F("no-cache") );
+  if ( server.header( "If-None-Match" ) != etag )
+    return false;
+  server.send( 304, F("application/json"), "" );
+  return true;
+}
+
+void beginChunkedJson( int returnCode )
+{
+  server.setContentLength( CONTENT_LENGTH_UNKNOWN );
+  server.send( returnCode, "application/json", "" );
+}
+
+//Matches JsonFlushFunction so a streaming JsonWriter can send each buffer-full as a chunk
+void sendChunk( const char* data, size_t len )
+{
+  if ( len > 0 )
+    server.sendContent( data, len );
+}
+
+void endChunked( void )
+{
+  server.sendContent( "" );
+}
+#endif
@@ -0,0 +1,275 @@
+/*
+File to define the MQTT switch state publishing for the ASCOM switch web driver.
+Each switch has a retained topic under <outSenseTopic>switch/<hostname>/<switch number> carrying its current value,
+so a dashboard can subscribe rather than poll /status.
+
+A change only marks the switch pending. serviceSwitchPublish() sends the pending switches once the first change in the
+batch is MQTT_COALESCE_MS old, and no sooner than MQTT_MIN_PUBLISH_INTERVAL_MS after the previous batch - so a burst of
+setswitch calls gives one message per switch carrying its final value. A switch set back to the value last published
+before its batch goes out sends nothing. The messages go through the outbound queue (Webrelay_mqttqueue.h), so changes
+made while the broker is unreachable are sent once it is back.
+
+Switches can also be set over MQTT, which saves a client with a broker connection open the TCP connect and request
+parse of an http call per change. Commands are published to
+  <outSenseTopic>switch/<hostname>/set        payload Id=<n>&State=true|false or Id=<n>&Value=<x>
+  <outSenseTopic>switch/<hostname>/<n>/set    payload as above without the Id, or just true, false or a number
+and may add ClientID and ClientTransactionID as for the http api. They go through the same checks as setswitch and
+setswitchvalue (applySwitchState() / applySwitchValue()). An Id on a per-switch topic must match the topic's switch
+number, or the command is refused. The Alpaca response is published to
+<outSenseTopic>switch/<hostname>/response with the command's ClientTransactionID, which serves as the correlation id.
+The callback only copies the command out of the client's buffer - which the reply publish would overwrite - and the
+commands are carried out from the loop by serviceMqttCommands().
+*/
+#ifndef _WEBRELAY_MQTT_H_
+#define _WEBRELAY_MQTT_H_
+
+#include "Webrelay_common.h"
+#include "Webrelay_json.h"
+#include "Webrelay_args.h"
+#include "Webrelay_mqttqueue.h"
+
+const unsigned long MQTT_COALESCE_MS = 100;
+const unsigned long MQTT_MIN_PUBLISH_INTERVAL_MS = 500;
+const int MQTT_COMMAND_LENGTH = 96;
+const int MQTT_COMMAND_QUEUE = 4;
+const int8_t MQTT_COMMAND_ANY_SWITCH = -1;
+
+typedef struct
+{
+  int8_t id;  //From the topic, or MQTT_COMMAND_ANY_SWITCH if the payload names it
+  char payload[ MQTT_COMMAND_LENGTH ];
+} MqttCommand;
+
+MqttCommand mqttCommands[ MQTT_COMMAND_QUEUE ];
+int mqttCommandHead = 0;
+int mqttCommandCount = 0;
+
+uint32_t switchPublishPending = 0;    //Bit per switch
+uint32_t switchPublishValid = 0;      //Bit per switch with a value in switchPublished
+float switchPublished[MAXSWITCH];
+unsigned long switchPublishFirstMs = 0;
+unsigned long switchPublishLastMs = 0;
+
+//definitions
+void markSwitchPublish( int id );
+void markAllSwitchPublish( void );
+void serviceSwitchPublish( void );
+void subscribeMqttCommands( void );
+bool queueMqttCommand( const char* topic, const byte* payload, unsigned int length );
+void serviceMqttCommands( void );
+
+void markSwitchPublish( int id )
+{
+  if ( id < 0 || id >= MAXSWITCH )
+    return;
+  if ( switchPublishPending == 0 )
+    switchPublishFirstMs = millis();
+  switchPublishPending |= ( 1UL << id );
+}
+
+//Publish every switch whether it has changed or not - to refresh the retained topics after a restart
+void markAllSwitchPublish( void )
+{
+  switchPublishValid = 0;
+  for ( int i = 0; i < numSwitches; i++ )
+    markSwitchPublish( i );
+}
+
+bool publishSwitch( int id )
+{
+  SwitchEntry& se = switchEntry[id];
+  JsonWriter json( mqttPublishBuffer, sizeof( mqttPublishBuffer ) );
+
+  if ( mqttBinaryTopic( MQTT_TOPIC_SWITCH ) )
+  {
+    TelemetrySwitch msg;
+    telemetryHeader( msg.header, TELEMETRY_SWITCH, sizeof( msg ) );
+    msg.id = (uint8_t) id;
+    msg.type = se.type;
+    msg.state = ( se.value == 1.0F ) ? 1 : 0;
+    msg.reserved = 0;
+    msg.value = se.value;
+    return enqueueMqtt( MQTT_TOPIC_SWITCH, (uint8_t) id, (const char*) &msg, sizeof( msg ), true );
+  }
+
+  json.beginObject();
+  json.add( "id", id );
+  json.add( "name", se.switchName );
+  json.add( "type", (int) se.type );
+  if ( se.type == SWITCH_RELAY_NO || se.type == SWITCH_RELAY_NC )
+    json.add( "state", ( se.value == 1.0F ) );
+  json.add( "value", (double) se.value );
+  json.endObject();
+  if ( json.overflowed() )
+    return false;
+  return enqueueMqtt( MQTT_TOPIC_SWITCH, (uint8_t) id, json.c_str(), json.length(), true );
+}
+
+/*
+ * Call every pass of the loop. Queues the pending switch values once the batch has settled.
+ */
+void serviceSwitchPublish( void )
+{
+  unsigned long now = millis();
+  int i = 0;
+
+  if ( switchPublishPending == 0 )
+    return;
+  if ( ( now - switchPublishFirstMs ) < MQTT_COALESCE_MS || ( now - switchPublishLastMs ) < MQTT_MIN_PUBLISH_INTERVAL_MS )
+    return;
+
+  for ( i = 0; i < numSwitches; i++ )
+  {
+    uint32_t bit = ( 1UL << i );
+    if ( !( switchPublishPending & bit ) )
+      continue;
+    if ( ( switchPublishValid & bit ) && switchPublished[i] == switchEntry[i].value )
+    {
+      switchPublishPending &= ~bit;
+      continue;
+    }
+    if ( !publishSwitch( i ) )
+    {
+      DEBUG_ESP( "serviceSwitchPublish: queueing failed for switch %d\n", i );
+      break;
+    }
+    switchPublished[i] = switchEntry[i].value;
+    switchPublishValid |= bit;
+    switchPublishPending &= ~bit;
+  }
+  //Switches no longer in use
+  switchPublishPending &= ( numSwitches >= 32 ) ? 0xFFFFFFFFUL : ( ( 1UL << numSwitches ) - 1 );
+  switchPublishLastMs = now;
+  switchPublishFirstMs = now;
+}
+
+void subscribeMqttCommands( void )
+{
+  client.subscribe( mqttTopicCommand );
+  client.subscribe( mqttTopicSwitchCommand );
+}
+
+/*
+ * Called from the MQTT callback. Returns false if the topic is not a switch command.
+ */
+bool queueMqttCommand( const char* topic, const byte* payload, unsigned int length )
+{
+  int id = MQTT_COMMAND_ANY_SWITCH;
+
+  if ( strncmp( topic, mqttTopicSwitchRoot, mqttTopicSwitchRootLength ) != 0 )
+    return false;
+  topic += mqttTopicSwitchRootLength;
+  if ( isdigit( *topic ) )
+  {
+    id = 0;
+    while ( isdigit( *topic ) && id < MAXSWITCH )
+      id = id * 10 + ( *topic++ - '0' );
+    if ( *topic++ != '/' || id >= MAXSWITCH )
+      return false;
+  }
+  if ( strcmp( topic, "set" ) != 0 )
+    return false;
+
+  if ( mqttCommandCount >= MQTT_COMMAND_QUEUE || length >= MQTT_COMMAND_LENGTH )
+  {
+    DEBUG_ESP( "queueMqttCommand: dropped command of length %u\n", length );
+    return true;
+  }
+  MqttCommand& cmd = mqttCommands[ ( mqttCommandHead + mqttCommandCount ) % MQTT_COMMAND_QUEUE ];
+  cmd.id = (int8_t) id;
+  memcpy( cmd.payload, payload, length );
+  cmd.payload[length] = '\0';
+  mqttCommandCount++;
+  return true;
+}
+
+//Split Key=value&Key=value in place, calling fn with the hash of each key. A bare value comes back with key 0.
+template <typename F> void parseMqttArgs( char* payload, F fn )
+{
+  char* p = payload;
+  char* arg = nullptr;
+
+  while ( ( arg = strtok_r( p, "&", &p ) ) != NULL )
+  {
+    char* eq = strchr( arg, '=' );
+    if ( eq == nullptr )
+      fn( (uint32_t) 0, arg );
+    else
+    {
+      *eq = '\0';
+      fn( argKeyHash( arg ), eq + 1 );
+    }
+  }
+}
+
+void runMqttCommand( MqttCommand& cmd )
+{
+  AlpacaResponse resp;
+  JsonWriter json( mqttPublishBuffer, sizeof( mqttPublishBuffer ) );
+  uint32_t clientID = 0, transID = 0;
+  int id = cmd.id;
+  bool idConflict = false;
+  const char* state = nullptr;
+  const char* value = nullptr;
+
+  parseMqttArgs( cmd.payload, [&]( uint32_t key, const char* v )
+  {
+    if ( key == ARG_ID )
+    {
+      //The topic names the switch - a payload Id can only agree with it
+      if ( cmd.id == MQTT_COMMAND_ANY_SWITCH )
+        id = atoi( v );
+      else if ( atoi( v ) != cmd.id )
+        idConflict = true;
+    }
+    else if ( key == ARG_STATE )
+      state = v;
+    else if ( key == ARG_VALUE )
+      value = v;
+    else if ( key == ARG_CLIENT_ID )
+      clientID = strtoul( v, nullptr, 10 );
+    else if ( key == ARG_CLIENT_TRANS_ID )
+      transID = strtoul( v, nullptr, 10 );
+    else if ( key == 0 )
+    {
+      //Bare payload - a boolean is a state, anything else a value
+      if ( strcasecmp( v, "true" ) == 0 || strcasecmp( v, "false" ) == 0 )
+        state = v;
+      else
+        value = v;
+    }
+  });
+
+  if ( idConflict )
+    alpacaResponseBuilder( resp, clientID, transID, serverTransID++, "SwitchState", invalidValue, "Id does not match the switch in the topic" );
+  else if ( state != nullptr )
+  {
+    alpacaResponseBuilder( resp, clientID, transID, serverTransID++, "SwitchState", Success, "" );
+    applySwitchState( resp, id, strcasecmp( state, "true" ) == 0, atol( state ) );
+  }
+  else if ( value != nullptr )
+  {
+    alpacaResponseBuilder( resp, clientID, transID, serverTransID++, "SwitchValue", Success, "" );
+    applySwitchValue( resp, id, (float) atof( value ) );
+  }
+  else
+    alpacaResponseBuilder( resp, clientID, transID, serverTransID++, "SwitchState", invalidValue, "Missing argument: State or Value" );
+
+  alpacaWriteResponse( json, resp );
+  if ( !json.overflowed() )
+    enqueueMqtt( MQTT_TOPIC_RESPONSE, 0, json.c_str(), json.length(), false );
+}
+
+/*
+ * Call every pass of the loop - carries out the commands queued by the callback.
+ */
+void serviceMqttCommands( void )
+{
+  while ( mqttCommandCount > 0 )
+  {
+    runMqttCommand( mqttCommands[ mqttCommandHead ] );
+    mqttCommandHead = ( mqttCommandHead + 1 ) % MQTT_COMMAND_QUEUE;
+    mqttCommandCount--;
+  }
+}
+#endif
@@ -0,0 +1,236 @@
+/*
+File to define the outbound MQTT message queue for the ASCOM switch web driver.
+Everything the device publishes - health, voltages, switch states and command responses - is queued here rather than
+published directly, and serviceMqttQueue() sends up to MQTT_DRAIN_BUDGET messages a loop pass while the broker is
+connected. So messages raised while the broker is away, e.g. the relay transitions during a broker restart, are sent
+in order once it is back instead of being lost, and a backlog cannot hold up the web server for long in any one pass.
+
+Messages are stored as a small header (topic id, switch number, retain flag, length) plus the payload in a fixed byte
+ring - the topic string is looked up when the message is sent. When a new message doesn't fit the oldest are dropped to
+make room and counted in mqttQueueDropped, which is reported in the health message. A message the broker connection
+refuses while still connected - one it could never send - is dropped and counted the same way rather than left to block
+the queue.
+
+Publishing allocates nothing. The topic strings are formatted once into static buffers by formatMqttTopics(), which
+must be called again whenever the hostname changes, and the timestamp is written into the caller's buffer. Payloads
+are written into mqttPublishBuffer and copied into the ring, and the same buffer is used to take them out again for
+sending - nothing runs between the two that could clash.
+
+Topics whose bit ( 1 << MqttTopicId ) is set in MQTT_BINARY_TOPICS are published as the packed structs of
+Webrelay_telemetry.h rather than json.
+*/
+#ifndef _WEBRELAY_MQTTQUEUE_H_
+#define _WEBRELAY_MQTTQUEUE_H_
+
+#include "Webrelay_common.h"
+#include "Webrelay_telemetry.h"
+#include <PubSubClient.h>
+#include <time.h>
+
+enum MqttTopicId { MQTT_TOPIC_HEALTH, MQTT_TOPIC_VOLTAGE, MQTT_TOPIC_SWITCH, MQTT_TOPIC_RESPONSE };
+
+#if !defined MQTT_BINARY_TOPICS
+#define MQTT_BINARY_TOPICS 0
+#endif
+
+const size_t MQTT_QUEUE_BYTES = 2048;
+const size_t MQTT_QUEUE_MAX_PAYLOAD = 768;
+const int MQTT_DRAIN_BUDGET = 4;
+const int MQTT_TOPIC_LENGTH = 96;
+const int MQTT_TOPIC_SUFFIX_LENGTH = 9;   //Longest suffix put after the switch root - "response"
+const int MQTT_TIMESTAMP_LENGTH = 48;
+
+typedef struct
+{
+  uint8_t topic;  //MqttTopicId
+  uint8_t index;  //Switch number for MQTT_TOPIC_SWITCH
+  uint8_t retain;
+  uint8_t reserved;
+  uint16_t length;
+} MqttQueueHeader;
+
+uint8_t mqttQueue[ MQTT_QUEUE_BYTES ];
+size_t mqttQueueHead = 0;   //Offset of the oldest message
+size_t mqttQueueUsed = 0;   //Bytes in use from the head
+int mqttQueueCount = 0;
+uint32_t mqttQueueDropped = 0;
+static char mqttPublishBuffer[ MQTT_QUEUE_MAX_PAYLOAD ];
+
+char mqttTopicHealth[ MQTT_TOPIC_LENGTH ];      //Also the last will topic
+char mqttTopicVoltage[ MQTT_TOPIC_LENGTH ];
+char mqttTopicSwitchRoot[ MQTT_TOPIC_LENGTH ];  //<outSenseTopic>switch/<hostname>/
+int mqttTopicSwitchRootLength = 0;
+char mqttTopicSwitch[ MQTT_TOPIC_LENGTH + 2 ];  //Root with the switch number (below 100) written after it per message
+//Root with a suffix after it - sized so a full length root is never cut short, which would subscribe to the wrong topic
+char mqttTopicResponse[ MQTT_TOPIC_LENGTH + MQTT_TOPIC_SUFFIX_LENGTH ];
+char mqttTopicCommand[ MQTT_TOPIC_LENGTH + MQTT_TOPIC_SUFFIX_LENGTH ];
+char mqttTopicSwitchCommand[ MQTT_TOPIC_LENGTH + MQTT_TOPIC_SUFFIX_LENGTH ];
+
+//definitions
+void formatMqttTopics( void );
+bool enqueueMqtt( MqttTopicId topic, uint8_t index, const char* payload, size_t length, bool retain );
+void serviceMqttQueue( void );
+
+bool mqttBinaryTopic( MqttTopicId topic )
+{
+  return ( MQTT_BINARY_TOPICS & ( 1 << topic ) ) != 0;
+}
+
+//The time laid out as getTimeAsString2() writes it - the form the Node-RED flows parse - into a caller's buffer
+const char* mqttTimestamp( char* buffer, size_t size )
+{
+  time_t now = time( nullptr );
+
+  if ( strftime( buffer, size, "%a %b %d %H:%M:%S %Y", gmtime( &now ) ) == 0 )
+    buffer[0] = '\0';
+  return buffer;
+}
+
+void telemetryHeader( TelemetryHeader& header, uint8_t type, size_t length )
+{
+  time_t now = time( nullptr );
+
+  header.version = TELEMETRY_VERSION;
+  header.type = type;
+  header.length = (uint16_t) length;
+  //Anything before 2001 means NTP hasn't answered yet
+  header.time = ( now > 1000000000L ) ? (uint32_t) now : 0;
+}
+
+/*
+ * Build all the topic strings from the hostname - call at startup and whenever the hostname changes.
+ */
+void formatMqttTopics( void )
+{
+  snprintf( mqttTopicHealth, MQTT_TOPIC_LENGTH, "%s%s", outHealthTopic, myHostname );
+  snprintf( mqttTopicVoltage, MQTT_TOPIC_LENGTH, "%svoltage/%s", outSenseTopic, myHostname );
+  if ( snprintf( mqttTopicSwitchRoot, MQTT_TOPIC_LENGTH, "%sswitch/%s/", outSenseTopic, myHostname ) >= MQTT_TOPIC_LENGTH )
+    DEBUGSL1( "formatMqttTopics: switch topic root too long - switch topics are cut short" );
+  mqttTopicSwitchRootLength = strlen( mqttTopicSwitchRoot );
+  strcpy( mqttTopicSwitch, mqttTopicSwitchRoot );
+  snprintf( mqttTopicResponse, sizeof( mqttTopicResponse ), "%sresponse", mqttTopicSwitchRoot );
+  snprintf( mqttTopicCommand, sizeof( mqttTopicCommand ), "%sset", mqttTopicSwitchRoot );
+  snprintf( mqttTopicSwitchCommand, sizeof( mqttTopicSwitchCommand ), "%s+/set", mqttTopicSwitchRoot );
+}
+
+const char* mqttTopic( uint8_t topic, uint8_t index )
+{
+  char* p = nullptr;
+
+  switch ( topic )
+  {
+    case MQTT_TOPIC_HEALTH:
+      return mqttTopicHealth;
+    case MQTT_TOPIC_VOLTAGE:
+      return mqttTopicVoltage;
+    case MQTT_TOPIC_SWITCH:
+      p = &mqttTopicSwitch[ mqttTopicSwitchRootLength ];
+      if ( index >= 10 )
+        *p++ = '0' + ( index / 10 ) % 10;
+      *p++ = '0' + index % 10;
+      *p = '\0';
+      return mqttTopicSwitch;
+    case MQTT_TOPIC_RESPONSE:
+    default:
+      return mqttTopicResponse;
+  }
+}
+
+//Ring copies - a message may wrap around the end of the buffer
+void mqttQueueWrite( size_t offset, const void* data, size_t length )
+{
+  const uint8_t* p = (const uint8_t*) data;
+  size_t pos = offset % MQTT_QUEUE_BYTES;
+  size_t first = ( length < MQTT_QUEUE_BYTES - pos ) ? length : MQTT_QUEUE_BYTES - pos;
+
+  memcpy( &mqttQueue[pos], p, first );
+  memcpy( &mqttQueue[0], p + first, length - first );
+}
+
+void mqttQueueRead( size_t offset, void* data, size_t length )
+{
+  uint8_t* p = (uint8_t*) data;
+  size_t pos = offset % MQTT_QUEUE_BYTES;
+  size_t first = ( length < MQTT_QUEUE_BYTES - pos ) ? length : MQTT_QUEUE_BYTES - pos;
+
+  memcpy( p, &mqttQueue[pos], first );
+  memcpy( p + first, &mqttQueue[0], length - first );
+}
+
+void mqttQueuePop( void )
+{
+  MqttQueueHeader header;
+  size_t size = 0;
+
+  if ( mqttQueueCount == 0 )
+    return;
+  mqttQueueRead( mqttQueueHead, &header, sizeof( header ) );
+  size = sizeof( header ) + header.length;
+  mqttQueueHead = ( mqttQueueHead + size ) % MQTT_QUEUE_BYTES;
+  mqttQueueUsed -= size;
+  mqttQueueCount--;
+}
+
+/*
+ * Add a message for sending. Drops the oldest messages if there isn't room; returns false if the message itself
+ * is too big to ever send - for the queue or for PubSubClient's packet buffer.
+ */
+bool enqueueMqtt( MqttTopicId topic, uint8_t index, const char* payload, size_t length, bool retain )
+{
+  MqttQueueHeader header;
+  size_t size = sizeof( header ) + length;
+  //As the check in PubSubClient::publish()
+  size_t packet = MQTT_MAX_HEADER_SIZE + 2 + strlen( mqttTopic( topic, index ) ) + length;
+
+  if ( length > MQTT_QUEUE_MAX_PAYLOAD || packet > MQTT_MAX_PACKET_SIZE )
+  {
+    DEBUG_ESP( "enqueueMqtt: message of %u bytes too long to send\n", (unsigned int) length );
+    mqttQueueDropped++;
+    return false;
+  }
+  while ( MQTT_QUEUE_BYTES - mqttQueueUsed < size )
+  {
+    mqttQueuePop();
+    mqttQueueDropped++;
+  }
+
+  header.topic = (uint8_t) topic;
+  header.index = index;
+  header.retain = ( retain ) ? 1 : 0;
+  header.reserved = 0;
+  header.length = (uint16_t) length;
+  mqttQueueWrite( mqttQueueHead + mqttQueueUsed, &header, sizeof( header ) );
+  mqttQueueWrite( mqttQueueHead + mqttQueueUsed + sizeof( header ), payload, length );
+  mqttQueueUsed += size;
+  mqttQueueCount++;
+  return true;
+}
+
+/*
+ * Call every pass of the loop. Sends from the front of the queue while connected, up to the budget.
+ * A message that fails to publish because the connection has gone stays at the front for when it is back; one that
+ * fails with the connection still up is dropped.
+ */
+void serviceMqttQueue( void )
+{
+  MqttQueueHeader header;
+  const char* topic = nullptr;
+  int sent = 0;
+
+  while ( mqttQueueCount > 0 && sent < MQTT_DRAIN_BUDGET && client.connected() )
+  {
+    mqttQueueRead( mqttQueueHead, &header, sizeof( header ) );
+    mqttQueueRead( mqttQueueHead + sizeof( header ), mqttPublishBuffer, header.length );
+    topic = mqttTopic( header.topic, header.index );
+    if ( !client.publish( topic, (const uint8_t*) mqttPublishBuffer, header.length, header.retain != 0 ) )
+    {
+      if ( !client.connected() )
+        break;
+      DEBUG_ESP( "serviceMqttQueue: publish to %s failed - dropped\n", topic );
+      mqttQueueDropped++;
+    }
+    mqttQueuePop();
+    sent++;
+  }
+}
+#endif
@@ -0,0 +1,208 @@
+/*
+File to define per-route request profiling for the ASCOM switch web driver.
+Turn on with PROFILE_HANDLERS in the main sketch. Every route registered through profiledOn() then records
+a latency histogram and heap usage for each request it serves, reported as json at /profile.
+With or without profiling, profiledOn() fills the request argument index (Webrelay_args.h) before calling the handler.
+Drive the routes with benchscript.sh from a linux host and compare the p50/p99 figures between builds - or without a
+board, with the host build in host/ (make -C host bench).
+
+Heap 'peak' is the largest amount of heap in use at any point inside the handler compared to the entry point,
+which is the figure that matters for fragmentation. It needs the core built with UMM_STATS_FULL, otherwise only the
+net heap retained across the call is available and peak reads as zero.
+*/
+#ifndef _WEBRELAY_PROFILE_H_
+#define _WEBRELAY_PROFILE_H_
+
+#include "Webrelay_common.h"
+#include "Webrelay_args.h"
+#include <ESP8266WebServer.h>
+
+//definitions
+void profiledOn( const char* uri, HTTPMethod method, WebServerType::THandlerFunction fn );
+void profiledOn( const char* uri, WebServerType::THandlerFunction fn );
+void handlerProfile(void);
+
+#if defined PROFILE_HANDLERS
+extern "C" {
+#include <umm_malloc/umm_malloc_cfg.h>
+}
+
+const int PROFILE_MAX_ROUTES = 48;
+//Log-linear latency buckets - 8us wide below 64us, then 2 buckets per power of 2 up to ~260ms.
+const int PROFILE_BUCKETS = 32;
+
+typedef struct
+{
+  const char* uri = nullptr;
+  uint32_t count = 0;
+  uint32_t totalUs = 0;
+  uint32_t maxUs = 0;
+  uint32_t heapPeakTotal = 0;
+  uint32_t heapPeakMax = 0;
+  int32_t heapRetained = 0; //Net heap lost across all calls - a steady rise is a leak
+  uint16_t hist[PROFILE_BUCKETS];
+} RouteProfile;
+
+RouteProfile routeProfiles[PROFILE_MAX_ROUTES];
+int numRouteProfiles = 0;
+uint32_t profileStartUs = 0;
+uint32_t profileStartHeap = 0;
+
+int profileBucket( uint32_t us )
+{
+  int bucket = 0;
+  int e = 0;
+
+  if ( us < 64 )
+    return us >> 3;
+
+  e = 31 - __builtin_clz( us ); //6 upwards
+  bucket = 8 + ( e - 6 ) * 2 + ( ( us >> ( e - 1 ) ) & 1 );
+  return ( bucket < PROFILE_BUCKETS ) ? bucket : PROFILE_BUCKETS - 1;
+}
+
+//Upper edge of the bucket in us - what a percentile in that bucket is reported as.
+uint32_t profileBucketLimit( int bucket )
+{
+  int e = 0;
+  if ( bucket < 8 )
+    return ( bucket + 1 ) << 3;
+  e = 6 + ( bucket - 8 ) / 2;
+  return ( 1UL << e ) + ( ( ( bucket - 8 ) % 2 ) + 1 ) * ( 1UL << ( e - 1 ) );
+}
+
+uint32_t profilePercentile( RouteProfile& rp, int percent )
+{
+  uint32_t target = ( rp.count * percent + 99 ) / 100;
+  uint32_t seen = 0;
+  for ( int i = 0; i < PROFILE_BUCKETS; i++ )
+  {
+    seen += rp.hist[i];
+    if ( seen >= target && seen > 0 )
+      return profileBucketLimit( i );
+  }
+  return 0;
+}
+
+void profileBegin( void )
+{
+#if defined UMM_STATS_FULL
+  umm_free_heap_size_min_reset();
+#endif
+  profileStartHeap = device.getFreeHeap();
+  profileStartUs = micros();
+}
+
+void profileEnd( int slot )
+{
+  uint32_t elapsed = micros() - profileStartUs;
+  uint32_t endHeap = device.getFreeHeap();
+  uint32_t peak = 0;
+  if ( slot < 0 )
+    return;
+  RouteProfile& rp = routeProfiles[slot];
+
+#if defined UMM_STATS_FULL
+  uint32_t minHeap = umm_free_heap_size_min();
+  if ( minHeap < profileStartHeap )
+    peak = profileStartHeap - minHeap;
+#endif
+
+  rp.count++;
+  rp.totalUs += elapsed;
+  if ( elapsed > rp.maxUs )
+    rp.maxUs = elapsed;
+  rp.heapPeakTotal += peak;
+  if ( peak > rp.heapPeakMax )
+    rp.heapPeakMax = peak;
+  rp.heapRetained += (int32_t) profileStartHeap - (int32_t) endHeap;
+  if ( rp.hist[ profileBucket( elapsed ) ] < 0xFFFF )
+    rp.hist[ profileBucket( elapsed ) ]++;
+}
+
+//Allocate a profile slot for a route - returns -1 when they have run out
+int profileRegister( const char* uri )
+{
+  int slot = numRouteProfiles;
+  if ( slot >= PROFILE_MAX_ROUTES )
+  {
+    DEBUGSL1( "profileRegister: out of profile slots" );
+    return -1;
+  }
+  numRouteProfiles++;
+  routeProfiles[slot].uri = uri;
+  memset( routeProfiles[slot].hist, 0, sizeof( routeProfiles[slot].hist ) );
+  return slot;
+}
+
+WebServerType::THandlerFunction profiledHandler( const char* uri, WebServerType::THandlerFunction fn )
+{
+  int slot = profileRegister( uri );
+  if ( slot < 0 )
+    return fn;
+  return [slot, fn]() { profileBegin(); fn(); profileEnd( slot ); };
+}
+
+void profiledOn( const char* uri, HTTPMethod method, WebServerType::THandlerFunction fn )
+{
+  server.on( uri, method, withRequestArgs( profiledHandler( uri, fn ) ) );
+}
+
+void profiledOn( const char* uri, WebServerType::THandlerFunction fn )
+{
+  server.on( uri, withRequestArgs( profiledHandler( uri, fn ) ) );
+}
+
+//GET /profile
+//Report the per-route statistics collected so far. Add reset=true to clear them after reporting.
+void handlerProfile(void)
+{
+  String message;
+  char line[200];
+  int i = 0;
+
+  server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+  server.send( 200, F("application/json"), "{\"routes\":[" );
+  for ( i = 0; i < numRouteProfiles; i++ )
+  {
+    RouteProfile& rp = routeProfiles[i];
+    snprintf( line, sizeof(line),
+              "%s{\"uri\":\"%s\",\"count\":%u,\"p50Us\":%u,\"p99Us\":%u,\"maxUs\":%u,\"meanUs\":%u,\"heapPeakMean\":%u,\"heapPeakMax\":%u,\"heapRetained\":%d}",
+              ( i == 0 ) ? "" : ",",
+              rp.uri, rp.count,
+              profilePercentile( rp, 50 ), profilePercentile( rp, 99 ), rp.maxUs,
+              ( rp.count > 0 ) ? rp.totalUs / rp.count : 0,
+              ( rp.count > 0 ) ? rp.heapPeakTotal / rp.count : 0, rp.heapPeakMax, rp.heapRetained );
+    message = line;
+    server.sendContent( message );
+  }
+  snprintf( line, sizeof(line), "],\"freeHeap\":%u,\"heapFragmentation\":%u}", device.getFreeHeap(), device.getHeapFragmentation() );
+  message = line;
+  server.sendContent( message );
+  server.sendContent( "" );
+
+  if ( requestArgs.isTrue( ARG_RESET ) )
+  {
+    for ( i = 0; i < numRouteProfiles; i++ )
+    {
+      const char* uri = routeProfiles[i].uri;
+      memset( &routeProfiles[i], 0, sizeof( RouteProfile ) );
+      routeProfiles[i].uri = uri;
+    }
+  }
+}
+
+#else
+//Profiling disabled - register the handlers directly.
+void profiledOn( const char* uri, HTTPMethod method, WebServerType::THandlerFunction fn )
+{
+  server.on( uri, method, withRequestArgs( fn ) );
+}
+
+void profiledOn( const char* uri, WebServerType::THandlerFunction fn )
+{
+  server.on( uri, withRequestArgs( fn ) );
+}
+#endif //PROFILE_HANDLERS
+
+#endif
@@ -0,0 +1,116 @@
+/*
+File to define the relay output shadow register for the ASCOM switch web driver.
+All relay changes are made to a RAM copy of the PCF8574 output byte and flushRelays() pushes it to the bus in a single
+write8, once per loop pass and only when it has changed. Nothing reads the expander back to find the relay state.
+
+The pin level for a relay is its state XOR its polarity bit. The polarity bit is set for Relay_NC switches (the contact
+is closed when the coil is not driven) and inverted again when the relay board has active-low inputs (reverseRelayLogic).
+Bits not used by a relay are held at the 'coil off' level.
+*/
+#ifndef _WEBRELAY_RELAYS_H_
+#define _WEBRELAY_RELAYS_H_
+
+#include "Webrelay_common.h"
+
+//The PCF8574 has 8 outputs - switches mapped above this have no relay to drive.
+const int RELAY_BITS = 8;
+
+uint8_t relayShadow = 0xFF;   //Output byte as it should be on the expander
+uint8_t relayPolarity = 0xFF; //Per-bit level for 'off'
+bool relayDirty = false;
+
+//definitions
+void updateRelayPolarity( void );
+void refreshRelayOutputs( void );
+void setRelayState( int id, bool state );
+bool flushRelays( void );
+
+/*
+ * Rebuild the polarity mask from the switch types - call when types or the number of switches change.
+ */
+void updateRelayPolarity( void )
+{
+  int i = 0;
+  uint8_t polarity = 0;
+
+  for ( i = 0; i < RELAY_BITS; i++ )
+  {
+    bool inverted = reverseRelayLogic;
+    if ( i < numSwitches && switchEntry[i].type == SWITCH_RELAY_NC )
+      inverted = !inverted;
+    if ( inverted )
+      polarity |= ( 1 << i );
+  }
+  relayPolarity = polarity;
+}
+
+/*
+ * Recompute the whole shadow byte from the current switch values and polarity.
+ * Non-relay and unused bits are set to the 'off' level.
+ */
+void refreshRelayOutputs( void )
+{
+  int i = 0;
+  uint8_t output = 0;
+
+  updateRelayPolarity();
+  for ( i = 0; i < RELAY_BITS; i++ )
+  {
+    bool state = false;
+    if ( i < numSwitches && ( switchEntry[i].type == SWITCH_RELAY_NO || switchEntry[i].type == SWITCH_RELAY_NC ) )
+      state = ( switchEntry[i].value > 0.0F );
+    if ( state != (bool) ( relayPolarity & ( 1 << i ) ) )
+      output |= ( 1 << i );
+  }
+
+  if ( output != relayShadow )
+  {
+    relayShadow = output;
+    relayDirty = true;
+  }
+}
+
+/*
+ * Set a relay on (closed circuit) or off in the shadow register and update its switch value.
+ * The bus write happens at the next flushRelays().
+ */
+void setRelayState( int id, bool state )
+{
+  uint8_t output = relayShadow;
+
+  switchEntry[id].value = ( state ) ? 1.0F : 0.0F;
+  onSwitchValueChanged( id );
+  if ( id >= RELAY_BITS )
+    return;
+
+  if ( state != (bool) ( relayPolarity & ( 1 << id ) ) )
+    output |= ( 1 << id );
+  else
+    output &= ~( 1 << id );
+
+  if ( output != relayShadow )
+  {
+    relayShadow = output;
+    relayDirty = true;
+  }
+}
+
+/*
+ * Write the shadow register to the expander if it has changed. Returns false if the bus write failed,
+ * in which case it stays dirty and is retried next time.
+ */
+bool flushRelays( void )
+{
+  if ( !relayDirty || !switchPresent )
+    return true;
+
+  switchDevice.write8( relayShadow );
+  if ( switchDevice.lastError() != PCF8574_OK )
+  {
+    DEBUGSL1( "flushRelays: bus write failed" );
+    return false;
+  }
+  relayDirty = false;
+  return true;
+}
+#endif
@@ -0,0 +1,190 @@
+/*
+File to define the route dispatcher for the ASCOM switch driver api namespace.
+Everything under /api/v1/switch/{instanceNumber}/ is served by the one RequestHandler below instead of a server.on()
+registration per method, each of which costs a heap allocated handler holding a String uri that the server string
+compares in turn on every request.
+
+The method segment is looked up with a binary search of a table sorted by name - at most 5 compares for the ~30 routes.
+Sort order is checked at compile time so an entry added in the wrong place fails the build rather than going missing.
+Each entry carries the mask of HTTP verbs it accepts; a known method with the wrong verb gets the same response as an
+unknown one, just as when the routes were registered individually.
+*/
+#ifndef _WEBRELAY_ROUTES_H_
+#define _WEBRELAY_ROUTES_H_
+
+#include "Webrelay_common.h"
+#include "Webrelay_args.h"
+#include "Webrelay_profile.h"
+#include <ESP8266WebServer.h>
+
+#define ROUTE_VERB(m) ( 1 << (m) )
+const uint8_t ROUTE_VERBS_ANY = 0xFF;
+const int MAX_ROUTE_METHOD_LENGTH = 24;
+
+typedef struct
+{
+  const char* method; //Path segment after the device number - lower case
+  uint8_t verbs;      //ROUTE_VERB() mask of the HTTPMethods accepted
+  void (*handler)(void);
+} AlpacaRoute;
+
+//Keep in strcmp order.
+constexpr AlpacaRoute alpacaRoutes[] =
+{
+  { "action",               ROUTE_VERB( HTTP_PUT ), handleAction },
+  { "canwrite",             ROUTE_VERB( HTTP_GET ), handlerDriver0CanWrite },
+  { "commandblind",         ROUTE_VERB( HTTP_PUT ), handleCommandBlind },
+  { "commandbool",          ROUTE_VERB( HTTP_PUT ), handleCommandBool },
+  { "commandstring",        ROUTE_VERB( HTTP_PUT ), handleCommandString },
+  { "connected",            ROUTE_VERBS_ANY,        handleConnected },
+  { "description",          ROUTE_VERB( HTTP_GET ), handleDescriptionGet },
+  { "driverinfo",           ROUTE_VERB( HTTP_GET ), handleDriverInfoGet },
+  { "driverversion",        ROUTE_VERB( HTTP_GET ), handleDriverVersionGet },
+  { "getswitch",            ROUTE_VERB( HTTP_GET ), handlerDriver0SwitchState },
+  { "getswitchdescription", ROUTE_VERB( HTTP_GET ), handlerDriver0SwitchDescription },
+  { "getswitchname",        ROUTE_VERB( HTTP_GET ), handlerDriver0SwitchName },
+  { "getswitchtype",        ROUTE_VERB( HTTP_GET ), handlerDriver0SwitchType },
+  { "getswitchvalue",       ROUTE_VERB( HTTP_GET ), handlerDriver0SwitchValue },
+  { "interfaceversion",     ROUTE_VERB( HTTP_GET ), handleInterfaceVersionGet },
+  { "maxswitch",            ROUTE_VERB( HTTP_GET ), handlerDriver0Maxswitch },
+  { "maxswitchvalue",       ROUTE_VERB( HTTP_GET ), handlerDriver0MaxSwitchValue },
+  { "minswitchvalue",       ROUTE_VERB( HTTP_GET ), handlerDriver0MinSwitchValue },
+  { "name",                 ROUTE_VERB( HTTP_GET ), handleNameGet },
+  { "numswitches",          ROUTE_VERBS_ANY,        handlerDriver0SetupNumSwitches },
+  { "setswitch",            ROUTE_VERB( HTTP_PUT ), handlerDriver0SwitchState },
+  { "setswitches",          ROUTE_VERB( HTTP_PUT ), handlerDriver0SetSwitches }, //Non-ASCOM batch set
+  { "setswitchname",        ROUTE_VERB( HTTP_PUT ), handlerDriver0SwitchName },
+  { "setswitchtype",        ROUTE_VERBS_ANY,        handlerDriver0SwitchType },
+  { "setswitchvalue",       ROUTE_VERB( HTTP_PUT ), handlerDriver0SwitchValue },
+  { "setup",                ROUTE_VERB( HTTP_GET ), handlerDriver0Setup }, //ALPACA driver setup - as called by chooser
+  { "supportedactions",     ROUTE_VERB( HTTP_GET ), handleSupportedActionsGet },
+  { "switches",             ROUTE_VERBS_ANY,        handlerDriver0SetupSwitches },
+  { "switchstep",           ROUTE_VERB( HTTP_GET ), handlerDriver0SwitchStep },
+};
+const int NUM_ALPACA_ROUTES = sizeof( alpacaRoutes ) / sizeof( alpacaRoutes[0] );
+
+constexpr bool routeNameLess( const char* a, const char* b )
+{
+  return ( *a == *b ) ? ( *a != '\0' && routeNameLess( a + 1, b + 1 ) ) : ( (uint8_t) *a < (uint8_t) *b );
+}
+
+constexpr bool routesSorted( int i )
+{
+  return ( i + 1 >= NUM_ALPACA_ROUTES ) ||
+         ( routeNameLess( alpacaRoutes[i].method, alpacaRoutes[i + 1].method ) && routesSorted( i + 1 ) );
+}
+static_assert( routesSorted( 0 ), "alpacaRoutes must be in strcmp order of method name" );
+
+//definitions
+int findAlpacaRoute( const char* method );
+
+//Returns the table index of the method, or -1. method must already be lower case.
+int findAlpacaRoute( const char* method )
+{
+  int low = 0;
+  int high = NUM_ALPACA_ROUTES - 1;
+
+  while ( low <= high )
+  {
+    int mid = ( low + high ) >> 1;
+    int cmp = strcmp( method, alpacaRoutes[mid].method );
+    if ( cmp == 0 )
+      return mid;
+    if ( cmp < 0 )
+      high = mid - 1;
+    else
+      low = mid + 1;
+  }
+  return -1;
+}
+
+#if defined USE_ASYNC_SERVER
+class AlpacaRequestHandler : public AsyncRequestHandler
+#else
+class AlpacaRequestHandler : public RequestHandler
+#endif
+{
+  public:
+    AlpacaRequestHandler() : _route( -1 )
+    {
+#if defined PROFILE_HANDLERS
+      for ( int i = 0; i < NUM_ALPACA_ROUTES; i++ )
+        _profileSlot[i] = profileRegister( alpacaRoutes[i].method );
+#endif
+    }
+
+    //Called by the server while parsing the request line - remember which route matched for handle()
+    bool canHandle( HTTPMethod method, const String& uri ) override
+    {
+      (void) method;
+      _route = matchUri( uri.c_str() );
+      return ( _route >= 0 );
+    }
+
+    bool canUpload( const String& uri ) override
+    {
+      (void) uri;
+      return false;
+    }
+
+    bool handle( WebServerType& server, HTTPMethod requestMethod, const String& requestUri ) override
+    {
+      (void) requestUri;
+      if ( _route < 0 )
+        return false;
+
+      requestArgs.parse( server );
+      if ( !( alpacaRoutes[_route].verbs & ROUTE_VERB( requestMethod ) ) )
+      {
+        handlerNotFound();
+        return true;
+      }
+
+#if defined PROFILE_HANDLERS
+      profileBegin();
+      alpacaRoutes[_route].handler();
+      profileEnd( _profileSlot[_route] );
+#else
+      alpacaRoutes[_route].handler();
+#endif
+      return true;
+    }
+
+  private:
+    int _route;
+#if defined PROFILE_HANDLERS
+    int _profileSlot[ NUM_ALPACA_ROUTES ];
+#endif
+
+    //Split /api/v1/switch/{n}/{method} and look the method up. Matching on the method is case-insensitive.
+    int matchUri( const char* uri )
+    {
+      static const char prefix[] = "/api/v1/" ASCOM_DEVICE_TYPE "/";
+      char method[ MAX_ROUTE_METHOD_LENGTH ];
+      int instance = 0;
+      int i = 0;
+
+      if ( strncmp( uri, prefix, sizeof( prefix ) - 1 ) != 0 )
+        return -1;
+      uri += sizeof( prefix ) - 1;
+
+      if ( !isdigit( *uri ) )
+        return -1;
+      while ( isdigit( *uri ) )
+        instance = instance * 10 + ( *uri++ - '0' );
+      if ( instance != instanceNumber || *uri++ != '/' )
+        return -1;
+
+      for ( i = 0; uri[i] != '\0'; i++ )
+      {
+        if ( i >= MAX_ROUTE_METHOD_LENGTH - 1 || uri[i] == '/' )
+          return -1;
+        method[i] = tolower( uri[i] );
+      }
+      method[i] = '\0';
+      return findAlpacaRoute( method );
+    }
+};
+
+AlpacaRequestHandler alpacaRequestHandler;
+#endif
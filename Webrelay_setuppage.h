@@ -0,0 +1,173 @@
+/*
+Generated by setup/make_setup_page.py from setup/setup.html - do not edit, re-run the script instead.
+6723 bytes of html, 2513 gzipped.
+*/
+#ifndef _WEBRELAY_SETUPPAGE_H_
+#define _WEBRELAY_SETUPPAGE_H_
+
+#include <pgmspace.h>
+
+#define SETUP_PAGE_ETAG "\"1894dd36\""
+const size_t SETUP_PAGE_LENGTH = 2513;
+const uint8_t setupPage[] PROGMEM =
+{
+  0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x9d, 0x19, 0x6b, 0x6f, 0xdb, 0x38,
+  0xf2, 0xbb, 0x7f, 0x05, 0xcb, 0x2e, 0x6a, 0x1b, 0x8d, 0xe5, 0xc7, 0x6d, 0x82, 0xc2, 0xaf, 0x45,
+  0xb6, 0xe9, 0xa1, 0x05, 0xba, 0x6d, 0xb0, 0x69, 0xf7, 0x70, 0x28, 0xfa, 0x81, 0x96, 0x28, 0x9b,
+  0x6b, 0x49, 0xd4, 0x51, 0xb4, 0x13, 0x5f, 0x37, 0xff, 0x7d, 0x67, 0x86, 0x94, 0x2c, 0xd9, 0xae,
+  0x9b, 0xbb, 0x2f, 0x91, 0x35, 0x1c, 0xce, 0xfb, 0xa9, 0x4c, 0x9f, 0xdd, 0x7c, 0x7c, 0xfd, 0xe9,
+  0xdf, 0xb7, 0x6f, 0xd8, 0xca, 0xa6, 0xc9, 0xbc, 0x35, 0xc5, 0x07, 0x4b, 0x44, 0xb6, 0x9c, 0x71,
+  0x99, 0x71, 0x04, 0x48, 0x11, 0xc1, 0x23, 0x95, 0x56, 0xb0, 0x70, 0x25, 0x4c, 0x21, 0xed, 0x8c,
+  0x6f, 0x6c, 0xdc, 0x7b, 0xc5, 0x4b, 0x70, 0x26, 0x52, 0x39, 0xe3, 0x5b, 0x25, 0xef, 0x73, 0x6d,
+  0x2c, 0x67, 0xa1, 0xce, 0xac, 0xcc, 0x00, 0xed, 0x5e, 0x45, 0x76, 0x35, 0x8b, 0xe4, 0x56, 0x85,
+  0xb2, 0x47, 0x2f, 0x17, 0x4c, 0x65, 0xca, 0x2a, 0x91, 0xf4, 0x8a, 0x50, 0x24, 0x72, 0x36, 0x44,
+  0x22, 0x56, 0xd9, 0x44, 0xce, 0xef, 0xee, 0x95, 0x0d, 0x57, 0x0c, 0xe8, 0x6f, 0xf2, 0x69, 0xdf,
+  0xc1, 0x5a, 0xd3, 0xc2, 0xee, 0xf0, 0xb9, 0xd0, 0xd1, 0x8e, 0x7d, 0x63, 0x31, 0x50, 0x1e, 0xb3,
+  0xe1, 0x65, 0xfe, 0xc0, 0x0a, 0x91, 0x15, 0xbd, 0x42, 0x1a, 0x15, 0x4f, 0x58, 0x2a, 0xcc, 0x52,
+  0x65, 0x63, 0x36, 0x60, 0x62, 0x63, 0x35, 0xbe, 0x3f, 0x38, 0x76, 0x63, 0x76, 0x79, 0x35, 0xc8,
+  0x1f, 0x26, 0x2c, 0x17, 0x51, 0xa4, 0xb2, 0x25, 0xa2, 0xbc, 0xc2, 0xf7, 0x50, 0x27, 0xda, 0x8c,
+  0xd9, 0xf3, 0xd1, 0x68, 0x34, 0x61, 0x8f, 0x2d, 0x54, 0x52, 0x1a, 0x60, 0xb0, 0x10, 0xe1, 0x7a,
+  0x69, 0xf4, 0x26, 0x8b, 0xe0, 0x50, 0x0c, 0x46, 0x74, 0x5e, 0x22, 0xc7, 0x71, 0x5c, 0xa3, 0x04,
+  0x74, 0xd8, 0x70, 0x84, 0xc4, 0x16, 0xda, 0xc0, 0xed, 0x9e, 0x11, 0x91, 0xda, 0x14, 0xc8, 0x62,
+  0xc0, 0xae, 0xe0, 0xf0, 0x0a, 0xcf, 0x2a, 0xda, 0x02, 0xa8, 0x37, 0x08, 0x39, 0xa1, 0x7b, 0x46,
+  0x2d, 0x57, 0xa8, 0xd3, 0xc8, 0x63, 0x8f, 0xbc, 0x9a, 0xbd, 0x42, 0xfd, 0x57, 0x02, 0x3c, 0x18,
+  0xca, 0x74, 0xaf, 0xe1, 0x30, 0x18, 0xc9, 0x14, 0xe8, 0x07, 0x3f, 0x23, 0xf4, 0xb1, 0x15, 0x6b,
+  0x93, 0x5e, 0xb0, 0x58, 0xc9, 0x24, 0x02, 0xc3, 0xa1, 0x02, 0x24, 0x0b, 0x20, 0xa2, 0x89, 0x74,
+  0xa2, 0x22, 0xf6, 0x3c, 0x0c, 0xc3, 0x23, 0x19, 0xaf, 0x1a, 0x46, 0xd9, 0xab, 0xb2, 0xb7, 0xe4,
+  0x80, 0x0d, 0x07, 0x4e, 0xa4, 0x44, 0x2c, 0x64, 0x02, 0xa4, 0x23, 0x55, 0xe4, 0x89, 0xd8, 0x8d,
+  0xd9, 0x22, 0xd1, 0xe1, 0x7a, 0x8f, 0xfb, 0x33, 0xdc, 0x1e, 0xec, 0x11, 0x8b, 0x5c, 0x64, 0x75,
+  0x6c, 0x95, 0x25, 0x2a, 0x93, 0x3d, 0x7f, 0xc9, 0xbb, 0x65, 0x78, 0x49, 0xc4, 0xad, 0x7c, 0xb0,
+  0x3d, 0x91, 0xa8, 0x25, 0x90, 0x21, 0x43, 0x1c, 0x9a, 0xe5, 0x95, 0x13, 0x41, 0x65, 0xf9, 0xc6,
+  0x5e, 0x40, 0x6c, 0x24, 0x32, 0xb4, 0x55, 0x1c, 0xa8, 0x6c, 0x05, 0xfe, 0xb7, 0x7b, 0xa2, 0xaf,
+  0x06, 0xce, 0x1d, 0x0f, 0x68, 0x3c, 0xd2, 0xcc, 0xab, 0x0d, 0xa0, 0x8a, 0xcc, 0x17, 0xbb, 0xcb,
+  0xe5, 0x0c, 0x0d, 0xa1, 0xbf, 0x02, 0x29, 0x7f, 0xd7, 0x05, 0x4e, 0x03, 0xa5, 0xd8, 0x2c, 0x52,
+  0x65, 0xbf, 0x5e, 0xb0, 0xc5, 0xc6, 0x5a, 0x9d, 0x1d, 0xe2, 0x96, 0xea, 0xa3, 0xab, 0xc9, 0x5c,
+  0x97, 0x5e, 0xd8, 0xe7, 0x69, 0xb1, 0xac, 0x1b, 0x20, 0xd3, 0x99, 0xac, 0x19, 0xfb, 0xea, 0xc8,
+  0xd8, 0xaf, 0x9c, 0x01, 0x4f, 0xb9, 0xa8, 0x11, 0x8f, 0x71, 0x14, 0x95, 0xf4, 0x03, 0xbd, 0x3e,
+  0x8c, 0xd6, 0x28, 0xa6, 0xd3, 0x60, 0xa5, 0x22, 0x79, 0xcc, 0xfe, 0xb1, 0x35, 0xed, 0xfb, 0x5c,
+  0x9a, 0xf6, 0x7d, 0x4e, 0x63, 0x52, 0xf9, 0x0c, 0x97, 0x06, 0xdf, 0x99, 0x8a, 0x66, 0x9c, 0x32,
+  0x8f, 0xfb, 0x74, 0x9c, 0xf6, 0x17, 0x73, 0xd6, 0x63, 0x77, 0xeb, 0xdd, 0x42, 0x44, 0x4b, 0x08,
+  0xe3, 0xa9, 0x60, 0x2b, 0x23, 0xe3, 0x19, 0x5f, 0x59, 0x9b, 0x17, 0xe3, 0x7e, 0xff, 0xfe, 0xfe,
+  0x3e, 0x10, 0x45, 0xa8, 0xd3, 0x5e, 0x61, 0x45, 0x16, 0x09, 0x13, 0x15, 0x81, 0x36, 0xcb, 0xbe,
+  0xc8, 0x15, 0x9f, 0x5f, 0xbf, 0xbf, 0xbd, 0x7e, 0x7d, 0x3d, 0xed, 0x8b, 0x39, 0xdb, 0x0e, 0x83,
+  0x01, 0x2b, 0x1c, 0xd1, 0x05, 0x72, 0x2b, 0x09, 0xf5, 0x29, 0xe3, 0xf9, 0xfc, 0x86, 0xca, 0x04,
+  0xe2, 0xee, 0x8f, 0x80, 0x48, 0x7f, 0x3b, 0xec, 0xbb, 0x6b, 0xfd, 0x41, 0x89, 0xea, 0x4b, 0xc5,
+  0xa0, 0x89, 0x0c, 0xfc, 0xed, 0xa6, 0x80, 0x53, 0x7a, 0xe2, 0x99, 0x57, 0x95, 0x94, 0x8b, 0xd4,
+  0x96, 0xd4, 0x03, 0xe3, 0xf1, 0xf9, 0xb4, 0x0f, 0xaf, 0x35, 0xa0, 0x2b, 0x51, 0x50, 0xb9, 0x12,
+  0x51, 0x14, 0xa0, 0x1b, 0x98, 0x90, 0x6a, 0xdf, 0x68, 0xfe, 0x56, 0x17, 0x16, 0xeb, 0x1b, 0x50,
+  0x1a, 0x01, 0x04, 0xf3, 0x8d, 0x89, 0xd0, 0x2a, 0x9d, 0x95, 0x92, 0xf7, 0x57, 0x1e, 0x85, 0xb3,
+  0x48, 0x58, 0xd1, 0x33, 0x12, 0x04, 0x31, 0x50, 0xfd, 0xa8, 0xb6, 0xe5, 0xf3, 0xd7, 0x2b, 0xa8,
+  0xa6, 0xe0, 0x79, 0x66, 0x57, 0x92, 0x95, 0xb8, 0xcc, 0xc8, 0x85, 0xd6, 0xb6, 0x20, 0xa0, 0xe3,
+  0xce, 0xc0, 0x7a, 0x10, 0x12, 0x3b, 0xac, 0xb2, 0xd9, 0x52, 0x32, 0x05, 0xa7, 0xef, 0x6e, 0x19,
+  0x84, 0x0d, 0x50, 0x2c, 0x82, 0x69, 0x3f, 0x07, 0x72, 0x94, 0x62, 0xf3, 0x29, 0xe6, 0x58, 0x4d,
+  0x34, 0x7a, 0x9d, 0x52, 0xe8, 0x32, 0x0a, 0x5d, 0x8e, 0x89, 0xc5, 0x7d, 0x61, 0xde, 0xcb, 0x87,
+  0xaa, 0x56, 0x6f, 0x60, 0x04, 0x47, 0xad, 0xd5, 0xb8, 0xe9, 0xa2, 0x9e, 0xb3, 0xad, 0x48, 0x36,
+  0xf0, 0x7a, 0x07, 0x55, 0x65, 0x7f, 0x05, 0x0c, 0x8a, 0x16, 0x70, 0xa6, 0x79, 0xaf, 0x43, 0x81,
+  0x86, 0x38, 0x63, 0x9a, 0xc4, 0xa3, 0xf0, 0x03, 0xd1, 0xf7, 0x57, 0xcf, 0x8b, 0x5e, 0xdd, 0x27,
+  0xd1, 0xf7, 0xd4, 0x9e, 0x2c, 0x7a, 0x5d, 0x80, 0x9a, 0xe8, 0x37, 0x0a, 0x22, 0x76, 0x2b, 0xcd,
+  0x8e, 0x61, 0xc7, 0x3a, 0xa3, 0xc0, 0x26, 0xca, 0xa9, 0xa7, 0x1d, 0xc8, 0xff, 0xf9, 0xe6, 0xd6,
+  0xdf, 0x3c, 0x96, 0x3f, 0xdb, 0xa4, 0x0b, 0x69, 0x4a, 0x0d, 0xa2, 0x92, 0x93, 0x6b, 0x8d, 0x14,
+  0x6c, 0x4d, 0x50, 0xaa, 0x80, 0xdd, 0x70, 0x30, 0xba, 0xe4, 0xd8, 0xb7, 0x66, 0xfc, 0xea, 0xf2,
+  0xf2, 0x1f, 0x97, 0xff, 0x83, 0x8a, 0xa5, 0x7c, 0xa5, 0x7a, 0x87, 0xa1, 0x6d, 0xd4, 0x16, 0xc5,
+  0x39, 0x0e, 0xed, 0x0f, 0x24, 0x28, 0xd3, 0xb1, 0x4f, 0x4b, 0x59, 0x9c, 0x34, 0xc4, 0x61, 0x0e,
+  0x82, 0x7e, 0x25, 0xbe, 0x0b, 0xf0, 0x6b, 0x2a, 0x6c, 0x15, 0x11, 0xb6, 0x96, 0x32, 0x77, 0x81,
+  0x2d, 0x1f, 0x54, 0x61, 0xe9, 0x0c, 0x8d, 0x39, 0x81, 0xa0, 0x4f, 0xf5, 0xd6, 0xa7, 0x42, 0xca,
+  0x22, 0xa3, 0x3d, 0x1e, 0x1c, 0x23, 0x5a, 0x81, 0xb2, 0x50, 0x96, 0x40, 0xf1, 0x87, 0x2c, 0x62,
+  0xce, 0x94, 0x32, 0x62, 0x50, 0xc2, 0x4e, 0x65, 0xc0, 0x5d, 0x25, 0xf7, 0x8f, 0xdc, 0x00, 0x6f,
+  0x25, 0xb2, 0x73, 0x42, 0x03, 0xe0, 0x5c, 0xf0, 0x44, 0x9b, 0x7f, 0xce, 0x21, 0xcd, 0x0f, 0x73,
+  0xc1, 0x57, 0x24, 0x98, 0x7c, 0x62, 0xb5, 0xdc, 0x98, 0x7a, 0x5e, 0x94, 0x8e, 0xd8, 0x1b, 0xad,
+  0x74, 0x91, 0x7f, 0x60, 0x3c, 0xfa, 0xda, 0x77, 0xc2, 0xfc, 0xbe, 0x9c, 0x9c, 0x28, 0x2e, 0xe7,
+  0x84, 0xfc, 0xdd, 0xe1, 0xf9, 0xd2, 0x82, 0x2c, 0xbd, 0xac, 0x79, 0xad, 0x60, 0x6e, 0x9c, 0x26,
+  0x24, 0x9d, 0xff, 0x3d, 0x77, 0xda, 0xc1, 0x44, 0x61, 0xd2, 0x7b, 0x61, 0x5c, 0x39, 0x26, 0xbb,
+  0x17, 0xa1, 0x51, 0xb9, 0x9d, 0xb7, 0xb6, 0xc2, 0xb0, 0x30, 0x5e, 0x4e, 0x5a, 0xf1, 0x26, 0x23,
+  0x19, 0xd9, 0x4f, 0x1d, 0x15, 0x75, 0xa1, 0xe3, 0x18, 0x70, 0xb2, 0xc9, 0x58, 0xa4, 0xc3, 0x4d,
+  0x0a, 0xe3, 0x5f, 0xb0, 0x94, 0xf6, 0x4d, 0x22, 0xf1, 0xe7, 0xaf, 0xbb, 0x77, 0x11, 0x22, 0xd1,
+  0xc4, 0x52, 0x5e, 0x2b, 0x56, 0xfa, 0xbe, 0x83, 0xc9, 0x7e, 0xc1, 0xf4, 0x1a, 0xee, 0x13, 0xe5,
+  0x94, 0xcd, 0x80, 0x1e, 0x15, 0xe9, 0xee, 0xa4, 0x95, 0x06, 0x78, 0xfe, 0xda, 0x8d, 0x93, 0x70,
+  0x82, 0x6f, 0x08, 0xa5, 0x58, 0xfe, 0x80, 0x65, 0x74, 0x06, 0x77, 0xd9, 0x2f, 0x8c, 0xeb, 0x35,
+  0x67, 0x63, 0xc6, 0x39, 0x9e, 0x52, 0x9b, 0x0b, 0x7c, 0xff, 0x03, 0x0c, 0x4e, 0xa3, 0x07, 0x1c,
+  0xd5, 0x98, 0xd3, 0xc4, 0xd4, 0x21, 0x6f, 0x5f, 0xd0, 0xe8, 0x8b, 0x02, 0x78, 0x05, 0x78, 0x23,
+  0xc6, 0x38, 0x7b, 0xc9, 0xdc, 0x60, 0xf3, 0x12, 0x4e, 0xfa, 0x15, 0x8c, 0x06, 0x65, 0x02, 0x39,
+  0xec, 0x26, 0x7d, 0x59, 0x84, 0x9d, 0xa2, 0x46, 0xf3, 0xce, 0x1a, 0x08, 0x70, 0x00, 0x05, 0x46,
+  0x82, 0x58, 0xa1, 0xec, 0xf4, 0x5f, 0xf4, 0x97, 0x17, 0x8c, 0xbf, 0x10, 0x69, 0x3e, 0xe1, 0x35,
+  0x30, 0x77, 0xe0, 0xff, 0x6c, 0xb4, 0x6d, 0xc0, 0xa7, 0x0e, 0x9e, 0x20, 0xb4, 0xc1, 0x0a, 0x92,
+  0xe7, 0x13, 0x84, 0x40, 0xd1, 0x51, 0xa5, 0x11, 0x23, 0xb5, 0x54, 0x56, 0x24, 0xce, 0x94, 0x18,
+  0x1e, 0x28, 0xaf, 0xea, 0x06, 0x14, 0x1b, 0x6c, 0x3e, 0x63, 0xa3, 0x09, 0xe1, 0x59, 0x9d, 0x03,
+  0x4e, 0x89, 0xfd, 0x0b, 0xba, 0x35, 0x48, 0x14, 0x84, 0x51, 0x11, 0x40, 0x25, 0xba, 0x71, 0xf0,
+  0x3f, 0xe0, 0x68, 0x7c, 0x70, 0xf4, 0xab, 0xca, 0x84, 0xd9, 0xc1, 0xc9, 0xa4, 0xf5, 0x85, 0xe7,
+  0x2a, 0xe3, 0x20, 0x59, 0xea, 0x1f, 0xe2, 0x01, 0x1f, 0x85, 0x95, 0x39, 0xff, 0x1a, 0x40, 0xd0,
+  0xbd, 0x11, 0xe1, 0xaa, 0x53, 0x09, 0xdb, 0x89, 0x4b, 0x21, 0x25, 0x89, 0x17, 0x93, 0x64, 0x93,
+  0x16, 0xf9, 0x4b, 0x2c, 0x12, 0xc8, 0xf5, 0x19, 0x7b, 0xe6, 0x45, 0x9a, 0xb4, 0x54, 0x0c, 0x37,
+  0xd8, 0x33, 0xf0, 0x21, 0x72, 0xc1, 0xab, 0x32, 0x00, 0x46, 0x80, 0x53, 0x17, 0x48, 0x65, 0x24,
+  0x8a, 0x44, 0xd1, 0x30, 0x4a, 0x74, 0x8e, 0x06, 0x7a, 0xec, 0xba, 0xfb, 0x25, 0x35, 0xbc, 0x0d,
+  0xf6, 0x40, 0x42, 0x75, 0x73, 0x34, 0x48, 0x65, 0x9b, 0x24, 0xb9, 0x55, 0xd9, 0x04, 0x11, 0xd3,
+  0x73, 0x88, 0x25, 0x4f, 0xc4, 0x03, 0x8d, 0xbf, 0x8f, 0xd7, 0x30, 0x16, 0x60, 0x93, 0x61, 0x9e,
+  0x88, 0xfe, 0xd8, 0x70, 0x33, 0x95, 0x8f, 0x7f, 0x42, 0x16, 0xbb, 0xc0, 0x42, 0x1b, 0x2a, 0xb8,
+  0x5d, 0x04, 0x2a, 0xba, 0x60, 0x68, 0x92, 0x36, 0xf6, 0x8f, 0x44, 0x66, 0x4b, 0xd8, 0xb9, 0x78,
+  0x1b, 0x78, 0x20, 0x61, 0x00, 0x61, 0xa2, 0xbc, 0x27, 0x30, 0xc0, 0xda, 0xbc, 0xed, 0x9d, 0x8f,
+  0x31, 0xe3, 0xb9, 0xd3, 0x6f, 0x40, 0xcd, 0x6b, 0x8e, 0x82, 0xb4, 0x5c, 0xd7, 0x02, 0xb8, 0x3d,
+  0xd5, 0x39, 0x1d, 0xf8, 0x02, 0x83, 0xf4, 0xd7, 0x8e, 0x1e, 0xfc, 0xed, 0xac, 0xd9, 0x0c, 0x45,
+  0x41, 0x42, 0x98, 0x8e, 0x7e, 0x52, 0x97, 0x91, 0xcb, 0xca, 0x2e, 0x26, 0x0a, 0x65, 0x8d, 0x75,
+  0x29, 0xe3, 0x68, 0x51, 0xce, 0x74, 0x83, 0x3f, 0xb5, 0xca, 0x3a, 0x1c, 0xa3, 0x1a, 0xe5, 0x02,
+  0xff, 0xa0, 0x58, 0x5f, 0x8e, 0xbd, 0xf2, 0x35, 0x80, 0xf2, 0x0a, 0xed, 0xbc, 0x83, 0x47, 0x88,
+  0xd6, 0x3d, 0x10, 0x39, 0xff, 0x81, 0xbc, 0xf9, 0x5e, 0xde, 0xdc, 0xc9, 0x0b, 0x54, 0xce, 0x8a,
+  0x0b, 0x78, 0x53, 0x18, 0xed, 0x01, 0x05, 0xa7, 0x68, 0x3c, 0xcd, 0xbb, 0x3f, 0xd4, 0x00, 0x5a,
+  0x0b, 0x28, 0x70, 0x10, 0xf2, 0x95, 0x58, 0xa7, 0x7a, 0x14, 0x06, 0xc5, 0x8c, 0x8b, 0x6c, 0xe7,
+  0x6a, 0x31, 0x4a, 0x48, 0x89, 0x41, 0xf2, 0xfa, 0x0e, 0x76, 0x00, 0xac, 0xa9, 0x55, 0x7c, 0x89,
+  0xbf, 0x12, 0x70, 0x0e, 0xae, 0x7d, 0x9c, 0xec, 0x59, 0x9d, 0xef, 0xe3, 0xb5, 0x7e, 0x54, 0xee,
+  0x8f, 0xf3, 0x69, 0x22, 0x97, 0x32, 0x8b, 0xca, 0x76, 0xd6, 0xf6, 0xfc, 0xb0, 0xc8, 0xb9, 0x03,
+  0x30, 0x4a, 0xab, 0xa9, 0x03, 0x0c, 0x14, 0x91, 0xcc, 0x4a, 0x29, 0x1d, 0xd1, 0x77, 0x51, 0x43,
+  0x40, 0xe5, 0xa5, 0x83, 0xbb, 0xae, 0xee, 0x72, 0x0c, 0x49, 0x28, 0x13, 0xed, 0xef, 0x0e, 0x7e,
+  0xf8, 0xb7, 0x7d, 0x52, 0x5b, 0xaa, 0xac, 0x01, 0x9e, 0x77, 0x2b, 0x77, 0x66, 0xce, 0x61, 0xdd,
+  0x3d, 0x83, 0x1b, 0xe9, 0xfa, 0x15, 0x8e, 0x7e, 0xe7, 0xf8, 0x44, 0x7b, 0xbc, 0x73, 0xec, 0x6a,
+  0x68, 0xe7, 0xb8, 0x62, 0x1d, 0x26, 0x76, 0x7e, 0x51, 0xa5, 0x75, 0x0a, 0x60, 0xed, 0x43, 0x67,
+  0x1e, 0x00, 0x21, 0xac, 0x69, 0xe6, 0x07, 0xfb, 0x95, 0xc5, 0xbc, 0x3a, 0xed, 0x92, 0xe1, 0x7c,
+  0xba, 0xba, 0x16, 0x44, 0xc4, 0x1b, 0x8c, 0xdf, 0xc2, 0xda, 0x85, 0xed, 0x9a, 0xb9, 0x62, 0xdc,
+  0x10, 0x00, 0x40, 0x47, 0xfc, 0x1b, 0x30, 0xa2, 0x4f, 0x69, 0xf7, 0x3d, 0xf2, 0xbf, 0x29, 0x9f,
+  0x47, 0x40, 0x1b, 0x62, 0xd6, 0xd5, 0xc6, 0x2e, 0x5a, 0xa2, 0x44, 0x80, 0xc2, 0xdb, 0x44, 0x80,
+  0xa2, 0x58, 0x47, 0xb8, 0xb3, 0x38, 0x13, 0x02, 0x19, 0x83, 0x7a, 0x96, 0x58, 0x54, 0x0c, 0xbb,
+  0x35, 0x46, 0xff, 0x82, 0x75, 0x5e, 0x62, 0x1b, 0x38, 0x72, 0x1a, 0xed, 0xeb, 0xa5, 0xf8, 0xf7,
+  0x25, 0xda, 0xb1, 0xcf, 0xc0, 0xdf, 0x94, 0xe0, 0x45, 0x50, 0x21, 0x51, 0x86, 0x43, 0xa4, 0x87,
+  0xeb, 0x66, 0x82, 0xb3, 0x1d, 0x58, 0xf4, 0x38, 0xa0, 0x9f, 0xcc, 0x29, 0x8e, 0x4f, 0xb2, 0x22,
+  0x16, 0x15, 0x3f, 0xcf, 0xca, 0xc0, 0x1a, 0x0a, 0x6e, 0x4e, 0x76, 0x64, 0xd6, 0xf6, 0x53, 0xe6,
+  0x4b, 0x18, 0xd9, 0xaa, 0xb4, 0x74, 0xd3, 0x5b, 0xbb, 0xd1, 0xf7, 0x0d, 0xe4, 0xa3, 0x34, 0x1d,
+  0x2c, 0x2e, 0xd5, 0xc8, 0x45, 0xbb, 0xbb, 0x2f, 0xea, 0xd5, 0xaa, 0xf9, 0x92, 0x0a, 0x1c, 0x2e,
+  0xce, 0xd4, 0x81, 0xdc, 0x7e, 0xdf, 0x3d, 0x18, 0xad, 0xea, 0x37, 0x08, 0xad, 0x5a, 0xfa, 0x9a,
+  0x8d, 0xea, 0x7b, 0x38, 0xe0, 0x70, 0xdf, 0x63, 0x66, 0x27, 0xfa, 0x4e, 0x8f, 0x0d, 0xe9, 0x42,
+  0xb5, 0x8e, 0x1d, 0x74, 0x3f, 0x0f, 0x3e, 0xc4, 0x79, 0x1a, 0xd1, 0xe6, 0x3e, 0xd5, 0xa4, 0x0c,
+  0xfb, 0xdb, 0x2d, 0x40, 0x09, 0xcf, 0x8f, 0xb8, 0xdd, 0x00, 0xc7, 0x5f, 0x9c, 0x0b, 0xf1, 0x13,
+  0xc6, 0xb8, 0xdf, 0xa7, 0x09, 0xcf, 0x33, 0x6d, 0x58, 0x6d, 0xcc, 0x7d, 0x13, 0x75, 0x37, 0x91,
+  0x10, 0x82, 0xcb, 0xb9, 0x99, 0x88, 0xd6, 0xf7, 0x88, 0x26, 0xeb, 0xda, 0xc9, 0x09, 0x4c, 0x37,
+  0xaa, 0x78, 0xa5, 0x1c, 0xdc, 0xcd, 0x07, 0x7b, 0x14, 0x95, 0x65, 0xd2, 0xbc, 0xfd, 0xf4, 0xdb,
+  0x7b, 0x8f, 0x58, 0x1e, 0x51, 0xd7, 0xdb, 0x8f, 0x03, 0xf5, 0xf6, 0xd3, 0x40, 0x3b, 0x1e, 0xbe,
+  0x70, 0x70, 0xd8, 0xcf, 0x8b, 0x38, 0x39, 0xe0, 0x48, 0x0e, 0xf7, 0x56, 0x5a, 0xaf, 0x3b, 0xcd,
+  0xb1, 0x32, 0xd1, 0x22, 0xa2, 0xe0, 0x8a, 0x25, 0x90, 0xeb, 0x94, 0x0b, 0xb1, 0xdb, 0x70, 0x20,
+  0x3d, 0xbf, 0xb1, 0x10, 0x88, 0xcb, 0x31, 0xb6, 0xc6, 0x1e, 0xfd, 0xe4, 0x40, 0x2a, 0x80, 0xf5,
+  0x2d, 0xab, 0x71, 0x34, 0xb5, 0xc5, 0xc0, 0x04, 0x7f, 0x16, 0x3a, 0xeb, 0x10, 0xcb, 0xd6, 0x21,
+  0x62, 0x88, 0x88, 0x20, 0x3e, 0xea, 0x3a, 0xa9, 0x62, 0xdb, 0xa1, 0x82, 0x6b, 0x1a, 0x6a, 0x90,
+  0x16, 0xb8, 0x3d, 0xf0, 0xcf, 0x19, 0x65, 0x9d, 0xd5, 0x2e, 0xc1, 0x6a, 0x1f, 0x53, 0xca, 0x95,
+  0x92, 0x7b, 0x0d, 0x6b, 0x9a, 0x39, 0x65, 0x41, 0xb3, 0x6b, 0x63, 0xc4, 0x2e, 0xc8, 0x8d, 0xb6,
+  0x1a, 0x33, 0xb1, 0x34, 0x18, 0xf0, 0x4b, 0x92, 0x4e, 0x95, 0x53, 0x98, 0x7a, 0xc5, 0xc5, 0x61,
+  0x3f, 0x8f, 0x03, 0x9d, 0xb9, 0xc4, 0x6d, 0xf4, 0x7a, 0xe9, 0x66, 0xd4, 0xdc, 0xc8, 0x2d, 0xdc,
+  0xbd, 0x91, 0xb1, 0xd8, 0x24, 0x16, 0x2d, 0xeb, 0xac, 0x18, 0xe3, 0x52, 0x74, 0x6d, 0x61, 0x19,
+  0x58, 0x6c, 0xac, 0xec, 0x70, 0xd7, 0x9c, 0x79, 0x17, 0xcd, 0x99, 0x4a, 0xbb, 0xd2, 0x11, 0xd8,
+  0xf3, 0xf6, 0xe3, 0xdd, 0x27, 0x30, 0x30, 0x7e, 0x9d, 0x1b, 0xb3, 0x4c, 0xde, 0xb3, 0xcf, 0xbf,
+  0xbf, 0xbf, 0x93, 0xc2, 0x84, 0xab, 0x5b, 0x61, 0x44, 0x5a, 0x74, 0x10, 0x86, 0x9e, 0xbf, 0x81,
+  0x8d, 0x10, 0xa4, 0xe9, 0x9e, 0xb2, 0xe7, 0x29, 0xc3, 0x9f, 0x34, 0xa4, 0xc7, 0xf9, 0xf6, 0x48,
+  0x76, 0xfa, 0x1e, 0x29, 0x9a, 0xa4, 0x4d, 0xe0, 0x3e, 0xb1, 0xc1, 0x40, 0x3e, 0x63, 0x1b, 0xf0,
+  0x50, 0xac, 0x32, 0x18, 0xd8, 0x5f, 0xbc, 0x60, 0xb5, 0x13, 0x36, 0x1a, 0x0c, 0xf0, 0x02, 0x39,
+  0xc8, 0x04, 0xd2, 0x18, 0x6d, 0xd8, 0x5f, 0x7f, 0x31, 0x5e, 0x6e, 0x96, 0x42, 0xe1, 0x94, 0xdf,
+  0xc1, 0xdc, 0xaa, 0xae, 0x41, 0x56, 0x75, 0x69, 0xad, 0x61, 0x32, 0x29, 0x24, 0xa3, 0xb1, 0x3f,
+  0xc0, 0x85, 0x17, 0xdc, 0x18, 0xf8, 0x9d, 0xb7, 0x22, 0xca, 0xdd, 0xb6, 0xcc, 0x3c, 0x1c, 0xbf,
+  0x27, 0xf4, 0xe0, 0x05, 0x03, 0x16, 0x22, 0x40, 0x15, 0x2c, 0x17, 0xf8, 0xf9, 0x2c, 0x63, 0x82,
+  0xc5, 0x60, 0xa9, 0x42, 0x42, 0xcc, 0x46, 0x05, 0x58, 0xd4, 0x9a, 0x8d, 0xdc, 0x33, 0x29, 0xa9,
+  0xdd, 0x89, 0x2d, 0xd4, 0xe9, 0xea, 0xd4, 0xc5, 0xbd, 0x5b, 0x20, 0xce, 0x84, 0xde, 0x91, 0x78,
+  0x58, 0xfa, 0xff, 0x3f, 0xc1, 0xb0, 0x5f, 0x7c, 0xc0, 0x08, 0x2e, 0x72, 0x88, 0x29, 0xb0, 0x90,
+  0xd1, 0x69, 0x2d, 0x94, 0x41, 0xb4, 0x67, 0xcf, 0x8e, 0xad, 0xe1, 0xc3, 0x7a, 0xd2, 0x72, 0xd1,
+  0xfd, 0x53, 0xa7, 0x2a, 0x61, 0xb9, 0xb0, 0x2b, 0x2c, 0x61, 0x50, 0x40, 0x22, 0xf9, 0xf0, 0x31,
+  0xee, 0xb8, 0xd9, 0x0f, 0x3a, 0x0f, 0xb8, 0x8d, 0x86, 0xd9, 0xf2, 0x9b, 0x10, 0x30, 0xf6, 0x3c,
+  0xba, 0x8d, 0x9d, 0x1a, 0xf7, 0xe8, 0xb2, 0x24, 0x94, 0xf6, 0x80, 0xc1, 0xc0, 0x7f, 0x01, 0x98,
+  0xf6, 0xfd, 0x87, 0xe3, 0x3e, 0xfd, 0xcf, 0xe8, 0x6f, 0xab, 0x67, 0x2d, 0xbd, 0x43, 0x1a, 0x00,
+  0x00,
+};
+#endif
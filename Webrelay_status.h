@@ -0,0 +1,217 @@
+/*
+File to define the /status document for the ASCOM switch web driver.
+Dashboards poll /status every few seconds and nearly every poll finds the same data, so the document is kept
+serialised in statusCache and only rebuilt when stateGeneration or the connected state has moved since it was built.
+A repeated poll is then a copy from the cache to the socket.
+
+Two fields change on every request or every second and are not kept in the cache as-is:
+  ServerTransactionID - left out, with its offset recorded, and written in at send time.
+  time                - built into the cache, which is then also rebuilt each STATUS_TIME_GRANULARITY_S. Define
+                        STATUS_SPLICE_TIME to treat it like the transaction id instead, so that only data changes
+                        rebuild the cache.
+A document too big for the cache - many switches with long names - is streamed out a switch at a time instead.
+*/
+#ifndef _WEBRELAY_STATUS_H_
+#define _WEBRELAY_STATUS_H_
+
+#include "Webrelay_common.h"
+#include "Webrelay_json.h"
+#include <time.h>
+
+#if !defined STATUS_CACHE_SIZE
+#define STATUS_CACHE_SIZE 2048
+#endif
+const time_t STATUS_TIME_GRANULARITY_S = 1;
+
+typedef struct
+{
+  size_t transIdAt;   //Offset the ServerTransactionID value goes in at
+  size_t timeAt;      //Offset the time value goes in at, with STATUS_SPLICE_TIME
+} StatusSplices;
+
+static char statusCache[ STATUS_CACHE_SIZE ];
+size_t statusCacheLength = 0;
+StatusSplices statusSplices;
+bool statusCacheBuilt = false;
+bool statusCacheFits = false;
+uint32_t statusCacheGeneration = 0;
+unsigned int statusCacheConnected = 0;
+time_t statusCacheTime = 0;
+
+//definitions
+void writeStatus( JsonWriter& writer, StatusSplices* splices );
+bool refreshStatusCache( void );
+void sendStatusCache( void );
+
+/*
+ * Write the whole document. With splices the values that change per request are left out and where they go recorded;
+ * without, they are written and each switch is flushed as a chunk of its own.
+ */
+void writeStatus( JsonWriter& writer, StatusSplices* splices )
+{
+  String timeString;
+  char buildVersion[64];
+  int i = 0;
+
+  writer.beginObject();
+  writer.beginArray( "switches" );
+  for ( i = 0; i < numSwitches; i++ )
+  {
+    SwitchEntry& se = switchEntry[i];
+
+    writer.beginObject();
+    writer.add( "description", se.description );
+    writer.add( "name",        se.switchName );
+    writer.add( "type",        (int) se.type );
+    writer.add( "pin",         (int) se.pin );
+    writer.add( "writeable",   se.writeable );
+    writer.add( "min",         (double) se.min );
+    writer.add( "max",         (double) se.max );
+    writer.add( "step",        (double) se.step );
+    if ( se.type == SWITCH_RELAY_NO || se.type == SWITCH_RELAY_NC )
+      writer.add( "state",     ( se.value == 1.0F ) );
+    else
+      writer.add( "value",     (double) se.value ); //Needs check limits to 1-1024, DAC and PWM limits.
+    writer.endObject();
+    //One chunk per switch when streaming
+    if ( splices == nullptr )
+      writer.flush();
+  }
+  writer.endArray();
+
+  //As alpacaWriteHeader() but with room for the transaction id
+  writer.add( "ClientTransactionID", (unsigned long) 0 );
+  if ( splices != nullptr )
+    splices->transIdAt = writer.addSplice( "ServerTransactionID" );
+  else
+    writer.add( "ServerTransactionID", (unsigned long) serverTransID++ );
+  writer.add( "Name", "Status" );
+  writer.add( "ErrorNumber", 0 );
+  writer.add( "ErrorMessage", "" );
+
+#if defined STATUS_SPLICE_TIME
+  if ( splices != nullptr )
+    splices->timeAt = writer.addSplice( "time" );
+  else
+#endif
+    writer.add( "time", getTimeAsString( timeString ).c_str() );
+  writer.add( "host", myHostname );
+  strncpy( buildVersion, __DATE__, sizeof( buildVersion ) - 1 );
+  buildVersion[ sizeof( buildVersion ) - 1 ] = '\0';
+  strncat_P( buildVersion, BuildVersionName, sizeof( buildVersion ) - strlen( buildVersion ) - 1 );
+  writer.add( "build version", buildVersion );
+  writer.add( "connected", ( connected != NOT_CONNECTED ) ? "true" : "false" );
+  writer.add( "connectedId", (int) connected );
+
+#if defined USE_ADC
+  writer.beginArray( "voltages" );
+  for ( i = 0; i < lastChannel; i++ )
+  {
+    writer.beginObject();
+    writer.add( "adcReading", (double) adcReading[i] );
+    writer.add( "adcScale",   (double) adcScaleFactor[i] );
+    writer.add( "adcGain",    (double) adcGainFactor[ adcReadingGain[i] ] );
+    //Over the rolling window of samples
+    writer.add( "voltageMean", (double) adcVolts( adcWindowMean( adcWindow[i] ) ) );
+    writer.add( "voltageMin",  (double) adcVolts( adcWindowMin( adcWindow[i] ) ) );
+    writer.add( "voltageMax",  (double) adcVolts( adcWindowMax( adcWindow[i] ) ) );
+    writer.add( "samples",     (int) adcWindow[i].count );
+    switch ( i )
+    {
+      case 0: writer.add( "12v Voltage", (double) adcVolts( adcMillivolts[i] ) );
+        break;
+      case 1: writer.add( "5v Voltage",  (double) adcVolts( adcMillivolts[i] ) );
+        break;
+      case 2: writer.add( "3v3 Voltage", (double) adcVolts( adcMillivolts[i] ) );
+        break;
+      case 3: writer.add( "Raw Voltage", (double) adcVolts( adcMillivolts[i] ) );
+        break;
+      default:
+        break;
+    }
+    writer.endObject();
+  }
+  writer.endArray();
+#endif
+  writer.endObject();
+}
+
+/*
+ * Rebuild the cache if anything in it is out of date. Returns false if the document doesn't fit.
+ */
+bool refreshStatusCache( void )
+{
+  time_t now = time( nullptr ) / STATUS_TIME_GRANULARITY_S;
+  bool current = statusCacheBuilt && statusCacheGeneration == stateGeneration && statusCacheConnected == connected;
+
+#if !defined STATUS_SPLICE_TIME
+  current = current && ( statusCacheTime == now );
+#endif
+  if ( current )
+    return statusCacheFits;
+
+  JsonWriter writer( statusCache, sizeof( statusCache ) );
+  statusSplices.timeAt = 0;
+  writeStatus( writer, &statusSplices );
+  statusCacheLength = writer.length();
+  statusCacheFits = !writer.overflowed();
+#if !defined STATUS_SPLICE_TIME
+  //Time comes within the cached part
+  statusSplices.timeAt = statusCacheLength;
+#endif
+  statusCacheBuilt = true;
+  statusCacheGeneration = stateGeneration;
+  statusCacheConnected = connected;
+  statusCacheTime = now;
+  if ( !statusCacheFits )
+    DEBUG_ESP( "refreshStatusCache: status needs more than %u bytes - streaming it\n", (unsigned int) sizeof( statusCache ) );
+  return statusCacheFits;
+}
+
+//Send the cache with the per-request values written in at the splice points
+void sendStatusCache( void )
+{
+  char transId[12];
+  char timeValue[48];
+  JsonWriter idWriter( transId, sizeof( transId ) );
+  JsonWriter timeWriter( timeValue, sizeof( timeValue ) );
+  size_t first = statusSplices.transIdAt;
+  size_t second = statusSplices.timeAt;
+
+  idWriter.add( nullptr, (unsigned long) serverTransID++ );
+#if defined STATUS_SPLICE_TIME
+  String timeString;
+  timeWriter.add( nullptr, getTimeAsString( timeString ).c_str() );
+#endif
+
+  server.setContentLength( statusCacheLength + idWriter.length() + timeWriter.length() );
+  server.send( 200, "application/json", "" );
+  sendChunk( statusCache, first );
+  sendChunk( idWriter.c_str(), idWriter.length() );
+  sendChunk( &statusCache[first], second - first );
+  sendChunk( timeWriter.c_str(), timeWriter.length() );
+  sendChunk( &statusCache[second], statusCacheLength - second );
+}
+
+//GET /status
+//Get a descriptor of all the switches managed by this driver for discovery purposes
+void handlerStatus(void)
+{
+  //Most polls find nothing changed - the time field is left as the client last saw it
+  if ( sendNotModified() )
+    return;
+
+  if ( refreshStatusCache() )
+  {
+    sendStatusCache();
+    return;
+  }
+
+  //Too big to cache - written out a chunk at a time through the response buffer
+  JsonWriter writer( responseBuffer, sizeof( responseBuffer ), sendChunk );
+  beginChunkedJson( 200 );
+  writeStatus( writer, nullptr );
+  writer.flush();
+  endChunked();
+}
+#endif
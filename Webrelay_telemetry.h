@@ -0,0 +1,73 @@
+/*
+File to define the binary telemetry payloads for the ASCOM switch web driver.
+Topics selected in MQTT_BINARY_TOPICS are published as one of the packed little-endian structs below instead of json,
+on the same topic. A binary payload starts with a version byte that has the top bit set, so it can never be mistaken
+for json, which starts with '{'. The voltage message with four channels is 53 bytes against ~600 as json.
+
+This file is plain C with no Arduino dependencies so that the decoder, telemetry_decode.c, builds from the same
+definitions on a linux host. Change TELEMETRY_VERSION whenever a layout changes.
+*/
+#ifndef _WEBRELAY_TELEMETRY_H_
+#define _WEBRELAY_TELEMETRY_H_
+
+#include <stdint.h>
+
+#define TELEMETRY_VERSION         0x81
+#define TELEMETRY_MAX_ADC_CHANNELS 4
+
+enum TelemetryType { TELEMETRY_HEALTH = 1, TELEMETRY_VOLTAGE = 2, TELEMETRY_SWITCH = 3 };
+
+typedef struct __attribute__((packed))
+{
+  uint8_t version;    //TELEMETRY_VERSION
+  uint8_t type;       //TelemetryType
+  uint16_t length;    //Of the whole payload in bytes
+  uint32_t time;      //Unix seconds, 0 if the clock isn't set
+} TelemetryHeader;
+
+typedef struct __attribute__((packed))
+{
+  TelemetryHeader header;
+  uint32_t uptime;    //Seconds
+  uint32_t freeHeap;
+  uint32_t mqttDropped;
+} TelemetryHealth;
+
+typedef struct __attribute__((packed))
+{
+  uint16_t millivolts;  //Latest, at the input
+  uint16_t meanMv;      //Over the rolling window
+  uint16_t minMv;
+  uint16_t maxMv;
+  uint16_t raw;         //Latest ADC count
+  uint8_t gain;         //Gain step the raw count was taken at
+} TelemetryChannel;
+
+typedef struct __attribute__((packed))
+{
+  TelemetryHeader header;
+  uint8_t channels;     //Entries in use in channel[]
+  TelemetryChannel channel[ TELEMETRY_MAX_ADC_CHANNELS ];
+} TelemetryVoltage;
+
+typedef struct __attribute__((packed))
+{
+  TelemetryHeader header;
+  uint8_t id;
+  uint8_t type;         //SwitchType
+  uint8_t state;        //Relays - 1 when on
+  uint8_t reserved;
+  float value;
+} TelemetrySwitch;
+
+#if defined __cplusplus
+#define TELEMETRY_ASSERT( c, m ) static_assert( c, m )
+#else
+#define TELEMETRY_ASSERT( c, m ) _Static_assert( c, m )
+#endif
+TELEMETRY_ASSERT( sizeof( TelemetryHeader ) == 8, "TelemetryHeader layout changed - bump TELEMETRY_VERSION" );
+TELEMETRY_ASSERT( sizeof( TelemetryHealth ) == 20, "TelemetryHealth layout changed - bump TELEMETRY_VERSION" );
+TELEMETRY_ASSERT( sizeof( TelemetryVoltage ) == 53, "TelemetryVoltage layout changed - bump TELEMETRY_VERSION" );
+TELEMETRY_ASSERT( sizeof( TelemetrySwitch ) == 16, "TelemetrySwitch layout changed - bump TELEMETRY_VERSION" );
+
+#endif
@@ -0,0 +1,85 @@
+#!/bin/bash
+# Request latency benchmark for the ASCOM switch device.
+# Drives every route registered in setup() back to back (no pauses, unlike testscript.bat) and reports
+# client-side p50/p99 latency per route. If the firmware was built with PROFILE_HANDLERS the device-side
+# handler time and heap figures are fetched from /profile at the end.
+# Usage: benchscript.sh [host] [requests per route]
+# Routes that restart the device or change its hostname, port or switch count are left out.
+
+HOST=${1:-espasw01}
+COUNT=${2:-50}
+ARGS="ClientID=99&ClientTransactionID=123"
+
+ROUTES=(
+  "GET  /"
+  "GET  /status"
+  "GET  /setup"
+  "GET  /api/v1/switch/0/setup"
+  "GET  /management/apiversions"
+  "GET  /management/v1/description"
+  "GET  /management/v1/configureddevices"
+  "GET  /api/v1/switch/0/connected"
+  "PUT  /api/v1/switch/0/connected Connected=true"
+  "GET  /api/v1/switch/0/description"
+  "GET  /api/v1/switch/0/driverinfo"
+  "GET  /api/v1/switch/0/driverversion"
+  "GET  /api/v1/switch/0/interfaceversion"
+  "GET  /api/v1/switch/0/name"
+  "GET  /api/v1/switch/0/supportedactions"
+  "PUT  /api/v1/switch/0/action Action=none&Parameters=none"
+  "PUT  /api/v1/switch/0/commandblind Command=none&Raw=true"
+  "PUT  /api/v1/switch/0/commandbool Command=none&Raw=true"
+  "PUT  /api/v1/switch/0/commandstring Command=none&Raw=true"
+  "GET  /api/v1/switch/0/maxswitch"
+  "GET  /api/v1/switch/0/canwrite Id=0"
+  "GET  /api/v1/switch/0/getswitchdescription Id=0"
+  "GET  /api/v1/switch/0/getswitch Id=0"
+  "PUT  /api/v1/switch/0/setswitch Id=0&State=false"
+  "PUT  /api/v1/switch/0/setswitches Id=0&State=false&Id=1&State=false"
+  "GET  /api/v1/switch/0/getswitchname Id=0"
+  "PUT  /api/v1/switch/0/setswitchname Id=0&Name=Switch_0"
+  "GET  /api/v1/switch/0/getswitchvalue Id=0"
+  "PUT  /api/v1/switch/0/setswitchvalue Id=0&Value=0"
+  "GET  /api/v1/switch/0/minswitchvalue Id=0"
+  "GET  /api/v1/switch/0/maxswitchvalue Id=0"
+  "GET  /api/v1/switch/0/switchstep Id=0"
+  "GET  /api/v1/switch/0/getswitchtype Id=0"
+  "GET  /api/v1/switch/0/nosuchroute"
+)
+
+percentile()
+{
+  # $1 = percentile, stdin = sorted list of times in ms
+  awk -v p="$1" '{ v[NR] = $1 } END { if ( NR == 0 ) { print "-"; exit } i = int( ( NR * p + 99 ) / 100 ); if ( i < 1 ) i = 1; printf "%.2f", v[i] }'
+}
+
+printf "%-45s %6s %9s %9s %9s\n" "route" "count" "p50 ms" "p99 ms" "max ms"
+for route in "${ROUTES[@]}"
+do
+  read -r method uri extra <<< "$route"
+  data="$ARGS"
+  if [ -n "$extra" ]; then
+    data="$data&$extra"
+  fi
+
+  times=$(
+    for (( i = 0; i < COUNT; i++ ))
+    do
+      if [ "$method" = "PUT" ]; then
+        curl -s -o /dev/null -w "%{time_total}\n" -X PUT -d "$data" "http://$HOST$uri"
+      else
+        curl -s -o /dev/null -w "%{time_total}\n" "http://$HOST$uri?$data"
+      fi
+    done | awk '{ printf "%.3f\n", $1 * 1000 }' | sort -n
+  )
+
+  p50=$(echo "$times" | percentile 50)
+  p99=$(echo "$times" | percentile 99)
+  max=$(echo "$times" | tail -n 1)
+  printf "%-45s %6d %9s %9s %9s\n" "$method $uri" "$COUNT" "$p50" "$p99" "$max"
+done
+
+echo
+echo "Device-side profile (needs PROFILE_HANDLERS):"
+curl -s "http://$HOST/profile"
+echo
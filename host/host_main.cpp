@@ -0,0 +1,290 @@
+/*
+Host build of the ASCOM switch sketch, for catching regressions without flashing a board.
+The sketch is compiled as it is for the device, against the stand-in headers in stubs/, and every route is driven
+through the ESP8266WebServer stand-in back to back. For each route it reports the handler latency percentiles, and
+the heap allocations made per request and the heap still held afterwards, both of which are counted here by wrapping
+malloc. Latency is of the host cpu, so compare figures between builds on the same machine rather than with the device.
+
+Usage: switch_host [requests per route]
+Exits non-zero if a route answers with anything but 200, or 304 to a revalidation.
+*/
+#include <Arduino.h>
+#include <malloc.h>
+#include <chrono>
+#include <vector>
+
+//Functions in the sketch used before they are defined - the Arduino builder writes these prototypes itself
+void callback( char* topic, byte* payload, unsigned int length );
+void onTimeoutTimer( void* pArg );
+
+#include "../ESP8266_AscomSwitch.ino"
+
+extern "C" void* __libc_malloc( size_t size );
+extern "C" void* __libc_calloc( size_t count, size_t size );
+extern "C" void* __libc_realloc( void* p, size_t size );
+extern "C" void __libc_free( void* p );
+
+HardwareSerial Serial;
+ESP8266WiFiClass WiFi;
+EEPROMClass EEPROM;
+TwoWire Wire;
+size_t hostHeapInUse = 0;
+uint32_t hostRestarts = 0;
+static size_t hostAllocCount = 0;
+static size_t hostAllocBytes = 0;
+static unsigned long hostClockOffsetUs = 0;
+static const std::chrono::steady_clock::time_point hostStart = std::chrono::steady_clock::now();
+
+//Heap accounting - everything, operator new included, comes through here
+extern "C" void* malloc( size_t size )
+{
+  void* p = __libc_malloc( size );
+  if ( p )
+  {
+    hostAllocCount++;
+    hostAllocBytes += size;
+    hostHeapInUse += malloc_usable_size( p );
+  }
+  return p;
+}
+
+extern "C" void* calloc( size_t count, size_t size )
+{
+  void* p = __libc_calloc( count, size );
+  if ( p )
+  {
+    hostAllocCount++;
+    hostAllocBytes += count * size;
+    hostHeapInUse += malloc_usable_size( p );
+  }
+  return p;
+}
+
+extern "C" void* realloc( void* old, size_t size )
+{
+  size_t oldSize = ( old ) ? malloc_usable_size( old ) : 0;
+  void* p = __libc_realloc( old, size );
+  if ( p )
+  {
+    hostAllocCount++;
+    hostAllocBytes += size;
+    hostHeapInUse += malloc_usable_size( p ) - oldSize;
+  }
+  return p;
+}
+
+extern "C" void free( void* p )
+{
+  if ( p )
+    hostHeapInUse -= malloc_usable_size( p );
+  __libc_free( p );
+}
+
+//delay() moves the clock on rather than waiting, so setup()'s pauses for the hardware cost nothing
+unsigned long micros( void )
+{
+  return (unsigned long) std::chrono::duration_cast<std::chrono::microseconds>( std::chrono::steady_clock::now() - hostStart ).count() + hostClockOffsetUs;
+}
+
+unsigned long millis( void )
+{
+  return micros() / 1000;
+}
+
+void delay( unsigned long ms )
+{
+  hostClockOffsetUs += ms * 1000;
+}
+
+void delayMicroseconds( unsigned int us )
+{
+  hostClockOffsetUs += us;
+}
+
+void yield( void )
+{
+}
+
+typedef struct
+{
+  const char* method;   //alpacaRoutes method
+  HTTPMethod verb;      //HTTP_ANY for GET if the route takes it, else PUT
+  const char* args[2];  //Alternate requests take turns, so a set really changes something
+  bool error;           //Answers with an Alpaca error - the handler isn't implemented
+} RouteArgs;
+
+//Switch 3 is made a PWM output before the run, for the value routes
+static const char* pwmSwitchSetup = "Id=3&Name=2";
+
+//Arguments beyond ClientID and ClientTransactionID, as benchscript.sh sends them. Routes not listed get Id=0.
+static const RouteArgs routeArgs[] =
+{
+  { "action",         HTTP_ANY, { "Action=none&Parameters=none", nullptr }, true },
+  { "commandblind",   HTTP_ANY, { "Command=none&Raw=true", nullptr }, true },
+  { "commandbool",    HTTP_ANY, { "Command=none&Raw=true", nullptr }, true },
+  { "commandstring",  HTTP_ANY, { "Command=none&Raw=true", nullptr }, true },
+  { "getswitchvalue", HTTP_ANY, { "Id=3", nullptr }, false },
+  { "numswitches",    HTTP_PUT, { "numSwitches=4", nullptr }, false },
+  { "setswitch",      HTTP_ANY, { "Id=0&State=true", "Id=0&State=false" }, false },
+  { "setswitches",    HTTP_ANY, { "Id=0&State=true&Id=1&State=true", "Id=0&State=false&Id=1&State=false" }, false },
+  { "setswitchname",  HTTP_ANY, { "Id=0&Name=Switch_A", "Id=0&Name=Switch_B" }, false },
+  { "setswitchvalue", HTTP_ANY, { "Id=3&Value=512", "Id=3&Value=0" }, false },
+  { "switches",       HTTP_PUT, { "switchId=3&name3=Heater&description3=Dew+heater&type3=2&writeable3=true&pin3=3&min3=0&max3=1024&step3=1",
+                                  "switchId=3&name3=Heater&description3=Dew+heater&type3=2&writeable3=true&pin3=3&min3=0&max3=512&step3=1" }, false },
+};
+
+typedef struct
+{
+  HTTPMethod verb;
+  const char* uri;
+  const char* ifNoneMatch;  //Sent as If-None-Match - "*" for the ETag of the previous response
+} OtherRoute;
+
+//The routes registered in setup() outside /api - /restart and the setup writes are left out as in benchscript.sh
+static const OtherRoute otherRoutes[] =
+{
+  { HTTP_GET, "/", nullptr },
+  { HTTP_GET, "/status", nullptr },
+  { HTTP_GET, "/status", "*" },
+  { HTTP_GET, "/setup", nullptr },
+  { HTTP_GET, "/setup/config", nullptr },
+  { HTTP_GET, "/management/apiversions", nullptr },
+  { HTTP_GET, "/management/v1/description", nullptr },
+  { HTTP_GET, "/management/v1/configureddevices", nullptr },
+  { HTTP_GET, "/api/v1/switch/0/nosuchroute", nullptr },
+};
+
+typedef struct
+{
+  std::vector<unsigned long> ns;
+  size_t allocs;
+  size_t bytes;
+  long retained;
+  int failures;
+} RouteResult;
+
+static int failures = 0;
+
+//The ETag header of the last response, for a revalidation to send back
+static void lastETag( char* etag, size_t size )
+{
+  const char* p = strstr( server.response(), "ETag: " );
+  size_t n = 0;
+
+  etag[0] = '\0';
+  if ( !p )
+    return;
+  p += 6;
+  while ( p[n] && p[n] != '\r' && n + 1 < size )
+    n++;
+  memcpy( etag, p, n );
+  etag[n] = '\0';
+}
+
+static bool alpacaError( void )
+{
+  const char* p = strstr( server.response(), "\"ErrorNumber\":" );
+  return ( p && atoi( p + 14 ) != 0 );
+}
+
+static void runRoute( const char* label, HTTPMethod verb, const char* uri, const char* args[2], const char* ifNoneMatch, bool error, int count )
+{
+  static const char* commonArgs = "ClientID=99&ClientTransactionID=123";
+  static const char* defaultArgs[2] = { "Id=0", nullptr };
+  RouteResult r;
+  char query[320];
+  char etag[64] = "";
+  int expected = ( ifNoneMatch ) ? 304 : ( strstr( uri, "nosuchroute" ) ? 400 : 200 );
+
+  if ( !args )
+    args = defaultArgs;
+  r.ns.reserve( count );
+  r.allocs = r.bytes = 0;
+  r.retained = 0;
+  r.failures = 0;
+  for ( int i = 0; i < count; i++ )
+  {
+    snprintf( query, sizeof( query ), "%s&%s", commonArgs, ( args[ i & 1 ] ) ? args[ i & 1 ] : args[0] );
+    if ( ifNoneMatch )
+    {
+      server.hostRequest( verb, uri, query );
+      lastETag( etag, sizeof( etag ) );
+    }
+
+    size_t allocs = hostAllocCount;
+    size_t bytes = hostAllocBytes;
+    long inUse = (long) hostHeapInUse;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    int code = server.hostRequest( verb, uri, query, ( ifNoneMatch ) ? etag : nullptr );
+    r.ns.push_back( std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now() - start ).count() );
+    r.allocs += hostAllocCount - allocs;
+    r.bytes += hostAllocBytes - bytes;
+    r.retained += (long) hostHeapInUse - inUse;
+
+    if ( code != expected || ( alpacaError() && !error && expected == 200 ) )
+    {
+      if ( r.failures++ == 0 )
+        fprintf( stderr, "%s: answered %d (expected %d)\n%.*s\n", label, code, expected, (int) server.responseLength(), server.response() );
+    }
+    //Let the deferred work - relay flush, publishing, EEPROM commit - run between requests as it would
+    loop();
+  }
+
+  std::sort( r.ns.begin(), r.ns.end() );
+  printf( "%-46s %6d %8lu %8lu %8lu %9.1f %9.1f %9ld %s\n", label, count,
+          r.ns[ ( count * 50 + 99 ) / 100 - 1 ], r.ns[ ( count * 99 + 99 ) / 100 - 1 ], r.ns.back(),
+          (double) r.allocs / count, (double) r.bytes / count, r.retained, ( r.failures ) ? "FAIL" : "" );
+  failures += r.failures;
+}
+
+int main( int argc, char** argv )
+{
+  int count = ( argc > 1 ) ? atoi( argv[1] ) : 1000;
+  char label[128];
+  char uri[96];
+
+  if ( count < 1 )
+    count = 1;
+  setup();
+  for ( int i = 0; i < 10; i++ )
+    loop();
+  snprintf( uri, sizeof( uri ), "/api/v1/%s/%d/setswitchtype", ASCOM_DEVICE_TYPE, instanceNumber );
+  if ( server.hostRequest( HTTP_PUT, uri, pwmSwitchSetup ) != 200 )
+  {
+    fprintf( stderr, "Couldn't make switch 3 a PWM output\n%.*s\n", (int) server.responseLength(), server.response() );
+    return 1;
+  }
+
+  printf( "%-46s %6s %8s %8s %8s %9s %9s %9s\n", "route", "count", "p50 ns", "p99 ns", "max ns", "allocs", "bytes", "retained" );
+  for ( int i = 0; i < NUM_ALPACA_ROUTES; i++ )
+  {
+    const AlpacaRoute& route = alpacaRoutes[i];
+    HTTPMethod verb = ( route.verbs & ROUTE_VERB( HTTP_GET ) ) ? HTTP_GET : HTTP_PUT;
+    const char** args = nullptr;
+    bool error = false;
+
+    for ( const RouteArgs& a : routeArgs )
+    {
+      if ( strcmp( a.method, route.method ) == 0 )
+      {
+        args = (const char**) a.args;
+        error = a.error;
+        if ( a.verb != HTTP_ANY )
+          verb = a.verb;
+      }
+    }
+    snprintf( uri, sizeof( uri ), "/api/v1/%s/%d/%s", ASCOM_DEVICE_TYPE, instanceNumber, route.method );
+    snprintf( label, sizeof( label ), "%s %s", ( verb == HTTP_GET ) ? "GET" : "PUT", uri );
+    runRoute( label, verb, uri, args, nullptr, error, count );
+  }
+  for ( const OtherRoute& route : otherRoutes )
+  {
+    snprintf( label, sizeof( label ), "GET %s%s", route.uri, ( route.ifNoneMatch ) ? " (If-None-Match)" : "" );
+    runRoute( label, route.verb, route.uri, nullptr, route.ifNoneMatch, false, count );
+  }
+
+  printf( "\nallocs and bytes are per request, retained is the heap still held after all of them. Restarts asked for: %u\n", hostRestarts );
+  if ( failures )
+    printf( "%d requests failed\n", failures );
+  return ( failures ) ? 1 : 0;
+}
@@ -0,0 +1,46 @@
+/*
+Stand-in for the Skybadger ASCOM common device handlers, for the host build.
+These answer with the same fields as the library but are not its code, so their figures in the benchmark are for the
+stand-in only.
+*/
+#ifndef _HOST_ASCOMAPICOMMON_REST_H_
+#define _HOST_ASCOMAPICOMMON_REST_H_
+#include <ESP8266WebServer.h>
+#include "AlpacaErrorConsts.h"
+
+unsigned int serverTransID = 0;
+const unsigned int NOT_CONNECTED = 0;
+
+void hostAlpacaReply( const char* name, const char* value, bool quoted, int errNum = Success, const char* errMsg = "" )
+{
+  char buf[384];
+  snprintf( buf, sizeof( buf ),
+            "{\"ClientID\":%s,\"ClientTransactionID\":%s,\"ServerTransactionID\":%u,\"Type\":\"%s\",\"Value\":%s%s%s,\"ErrorNumber\":%d,\"ErrorMessage\":\"%s\"}",
+            server.hasArg( "ClientID" ) ? server.arg( "ClientID" ).c_str() : "0",
+            server.hasArg( "ClientTransactionID" ) ? server.arg( "ClientTransactionID" ).c_str() : "0",
+            serverTransID++, name, quoted ? "\"" : "", value, quoted ? "\"" : "", errNum, errMsg );
+  server.send( 200, "application/json", buf );
+}
+
+void handleAction( void )               { hostAlpacaReply( "Action", "", true, notImplemented, "Not implemented" ); }
+void handleCommandBlind( void )         { hostAlpacaReply( "CommandBlind", "", true, notImplemented, "Not implemented" ); }
+void handleCommandBool( void )          { hostAlpacaReply( "CommandBool", "false", false, notImplemented, "Not implemented" ); }
+void handleCommandString( void )        { hostAlpacaReply( "CommandString", "", true, notImplemented, "Not implemented" ); }
+void handleDescriptionGet( void )       { hostAlpacaReply( "Description", Description, true ); }
+void handleDriverInfoGet( void )        { hostAlpacaReply( "DriverInfo", DriverInfo, true ); }
+void handleDriverVersionGet( void )     { hostAlpacaReply( "DriverVersion", DriverVersion, true ); }
+void handleInterfaceVersionGet( void )  { hostAlpacaReply( "InterfaceVersion", InterfaceVersion, false ); }
+void handleNameGet( void )              { hostAlpacaReply( "Name", DriverName, true ); }
+void handleSupportedActionsGet( void )  { hostAlpacaReply( "SupportedActions", "[]", false ); }
+
+void handleConnected( void )
+{
+  if ( server.method() == HTTP_PUT )
+  {
+    connected = server.arg( "Connected" ).equalsIgnoreCase( "true" );
+    hostAlpacaReply( "Connected", "", true );
+    return;
+  }
+  hostAlpacaReply( "Connected", connected ? "true" : "false", false );
+}
+#endif
@@ -0,0 +1 @@
+//The switch handlers are all in ESP8266_relayhandler.h - nothing to stand in for
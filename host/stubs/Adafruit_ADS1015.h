@@ -0,0 +1,27 @@
+//Stand-in for the Adafruit ADS1015 library, for the host build - Webrelay_adc.h drives the device over Wire itself
+#ifndef _HOST_ADAFRUIT_ADS1015_H_
+#define _HOST_ADAFRUIT_ADS1015_H_
+#include <Wire.h>
+
+typedef enum
+{
+  GAIN_TWOTHIRDS = 0x0000,
+  GAIN_ONE = 0x0200,
+  GAIN_TWO = 0x0400,
+  GAIN_FOUR = 0x0600,
+  GAIN_EIGHT = 0x0800,
+  GAIN_SIXTEEN = 0x0A00
+} adsGain_t;
+
+class Adafruit_ADS1015
+{
+  public:
+    Adafruit_ADS1015( uint8_t address = 0x48 ) : _address( address ) {}
+    void begin() {}
+    void setGain( adsGain_t gain ) { _gain = gain; }
+    adsGain_t getGain() { return _gain; }
+  private:
+    uint8_t _address;
+    adsGain_t _gain = GAIN_TWOTHIRDS;
+};
+#endif
@@ -0,0 +1,16 @@
+//Stand-in for the Skybadger Alpaca error numbers, for the host build
+#ifndef _HOST_ALPACAERRORCONSTS_H_
+#define _HOST_ALPACAERRORCONSTS_H_
+const int Success = 0;
+const int notImplemented = 0x400;
+const int invalidValue = 0x401;
+const int valueNotSet = 0x402;
+const int notConnected = 0x407;
+const int invalidWhileParked = 0x408;
+const int invalidWhileSlaved = 0x409;
+const int settingsProviderError = 0x40A;
+const int invalidOperation = 0x40B;
+const int actionNotImplemented = 0x40C;
+const int driverBase = 0x500;
+const int driverMax = 0xFFF;
+#endif
@@ -0,0 +1,21 @@
+//Stand-in for the Skybadger Alpaca management handlers, for the host build - see ASCOMAPICommon_rest.h
+#ifndef _HOST_ALPACAMANAGEMENT_H_
+#define _HOST_ALPACAMANAGEMENT_H_
+#include "ASCOMAPICommon_rest.h"
+
+void handleMgmtVersions( void )          { hostAlpacaReply( "ApiVersions", "[1]", false ); }
+void handleMgmtDescription( void )
+{
+  char value[192];
+  snprintf( value, sizeof( value ), "{\"ServerName\":\"%s\",\"Manufacturer\":\"Skybadger\",\"ManufacturerVersion\":\"%s\",\"Location\":\"%s\"}",
+            myHostname, DriverVersion, Location );
+  hostAlpacaReply( "Description", value, false );
+}
+void handleMgmtConfiguredDevices( void )
+{
+  char value[192];
+  snprintf( value, sizeof( value ), "[{\"DeviceName\":\"%s\",\"DeviceType\":\"%s\",\"DeviceNumber\":%d,\"UniqueID\":\"%s\"}]",
+            myHostname, DriverType, instanceNumber, GUID );
+  hostAlpacaReply( "ConfiguredDevices", value, false );
+}
+#endif
@@ -0,0 +1,299 @@
+/*
+Stand-in for the ESP8266 Arduino core, for the host build in host/.
+Only what the sketch uses - timing, pins, Serial, PROGMEM and String. millis() and micros() run from the host clock.
+*/
+#ifndef _HOST_ARDUINO_H_
+#define _HOST_ARDUINO_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <math.h>
+#include <stdarg.h>
+#include <time.h>
+#include <algorithm>
+#include <functional>
+#include <cmath>
+
+using std::isnan;
+using std::isinf;
+using std::min;
+using std::max;
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define PROGMEM
+#define PGM_P const char*
+#define PSTR(s) (s)
+#define FPSTR(p) ((const __FlashStringHelper*)(p))
+#define F(s) ((const __FlashStringHelper*)(s))
+#define memcpy_P memcpy
+#define strcpy_P strcpy
+#define strncpy_P strncpy
+#define strcat_P strcat
+#define strncat_P strncat
+#define strcmp_P strcmp
+#define strlen_P strlen
+#define sprintf_P sprintf
+#define snprintf_P snprintf
+#define pgm_read_byte(p) (*(const uint8_t*)(p))
+#define ICACHE_RAM_ATTR
+#define IRAM_ATTR
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+
+class __FlashStringHelper;
+
+unsigned long millis( void );
+unsigned long micros( void );
+void delay( unsigned long ms );
+void delayMicroseconds( unsigned int us );
+void yield( void );
+inline void pinMode( uint8_t, uint8_t ) {}
+inline void digitalWrite( uint8_t, uint8_t ) {}
+inline int digitalRead( uint8_t ) { return 0; }
+inline void analogWrite( uint8_t, int ) {}
+inline void analogWriteRange( uint32_t ) {}
+inline void analogWriteFreq( uint32_t ) {}
+inline long random( long howBig ) { return ( howBig > 0 ) ? rand() % howBig : 0; }
+inline long random( long lo, long hi ) { return ( hi > lo ) ? lo + rand() % ( hi - lo ) : lo; }
+
+//Held as the core's String holds it - up to 10 characters inside the object, longer on the heap sized to fit - so
+//the allocations counted by the host build are those the device would make.
+class String
+{
+  public:
+    String() { init(); }
+    String( const char* s ) { init(); if ( s ) copy( s, strlen( s ) ); }
+    String( const __FlashStringHelper* s ) : String( (const char*) s ) {}
+    String( const String& s ) { init(); copy( s.c_str(), s._len ); }
+    String( String&& s ) { init(); move( s ); }
+    String( char c ) { init(); copy( &c, 1 ); }
+    explicit String( int v, unsigned char base = 10 ) { init(); fromLong( v, base ); }
+    explicit String( unsigned int v, unsigned char base = 10 ) { init(); fromULong( v, base ); }
+    explicit String( long v, unsigned char base = 10 ) { init(); fromLong( v, base ); }
+    explicit String( unsigned long v, unsigned char base = 10 ) { init(); fromULong( v, base ); }
+    explicit String( float v, unsigned char decimals = 2 ) { init(); fromDouble( v, decimals ); }
+    explicit String( double v, unsigned char decimals = 2 ) { init(); fromDouble( v, decimals ); }
+    ~String() { free( _heap ); }
+    String& operator=( const String& s ) { if ( this != &s ) copy( s.c_str(), s._len ); return *this; }
+    String& operator=( String&& s ) { if ( this != &s ) move( s ); return *this; }
+    String& operator=( const char* s ) { if ( s ) copy( s, strlen( s ) ); else copy( "", 0 ); return *this; }
+
+    const char* c_str() const { return ( _heap ) ? _heap : _sso; }
+    unsigned int length() const { return _len; }
+    bool reserve( unsigned int n ) { return n <= _cap || grow( n ); }
+    char charAt( unsigned int i ) const { return ( i < _len ) ? c_str()[i] : 0; }
+    char operator[]( unsigned int i ) const { return charAt( i ); }
+    char& operator[]( unsigned int i ) { return buffer()[i]; }
+
+    bool concat( const char* s, unsigned int n )
+    {
+      if ( !reserve( _len + n ) )
+        return false;
+      memmove( buffer() + _len, s, n );
+      _len += n;
+      buffer()[_len] = '\0';
+      return true;
+    }
+    bool concat( const String& s ) { return concat( s.c_str(), s._len ); }
+    bool concat( const char* s ) { return ( s ) ? concat( s, strlen( s ) ) : false; }
+    bool concat( char c ) { return concat( &c, 1 ); }
+    bool concat( int v ) { char b[12]; snprintf( b, sizeof( b ), "%d", v ); return concat( b ); }
+    bool concat( unsigned int v ) { char b[12]; snprintf( b, sizeof( b ), "%u", v ); return concat( b ); }
+    bool concat( long v ) { char b[24]; snprintf( b, sizeof( b ), "%ld", v ); return concat( b ); }
+    bool concat( unsigned long v ) { char b[24]; snprintf( b, sizeof( b ), "%lu", v ); return concat( b ); }
+    bool concat( float v ) { return concat( (double) v ); }
+    bool concat( double v ) { char b[48]; snprintf( b, sizeof( b ), "%.2f", v ); return concat( b ); }
+    bool concat( const __FlashStringHelper* s ) { return concat( (const char*) s ); }
+    template <typename T> String& operator+=( const T& v ) { concat( v ); return *this; }
+
+    bool equals( const String& s ) const { return _len == s._len && strcmp( c_str(), s.c_str() ) == 0; }
+    bool equals( const char* s ) const { return strcmp( c_str(), ( s ) ? s : "" ) == 0; }
+    bool equalsIgnoreCase( const String& s ) const { return _len == s._len && strcasecmp( c_str(), s.c_str() ) == 0; }
+    bool operator==( const String& s ) const { return equals( s ); }
+    bool operator==( const char* s ) const { return equals( s ); }
+    bool operator!=( const String& s ) const { return !equals( s ); }
+    bool operator!=( const char* s ) const { return !equals( s ); }
+    bool operator<( const String& s ) const { return strcmp( c_str(), s.c_str() ) < 0; }
+    int compareTo( const String& s ) const { return strcmp( c_str(), s.c_str() ); }
+    bool startsWith( const String& s ) const { return _len >= s._len && strncmp( c_str(), s.c_str(), s._len ) == 0; }
+    bool endsWith( const String& s ) const { return _len >= s._len && strcmp( c_str() + _len - s._len, s.c_str() ) == 0; }
+
+    int indexOf( char c, unsigned int from = 0 ) const { const char* p = ( from < _len ) ? strchr( c_str() + from, c ) : nullptr; return ( p ) ? (int) ( p - c_str() ) : -1; }
+    int indexOf( const String& s, unsigned int from = 0 ) const { const char* p = ( from <= _len ) ? strstr( c_str() + from, s.c_str() ) : nullptr; return ( p ) ? (int) ( p - c_str() ) : -1; }
+    int lastIndexOf( char c ) const { const char* p = strrchr( c_str(), c ); return ( p ) ? (int) ( p - c_str() ) : -1; }
+    String substring( unsigned int from ) const { return substring( from, _len ); }
+    String substring( unsigned int from, unsigned int to ) const
+    {
+      String r;
+      if ( to > _len )
+        to = _len;
+      if ( from < to )
+        r.concat( c_str() + from, to - from );
+      return r;
+    }
+    void toLowerCase() { for ( unsigned int i = 0; i < _len; i++ ) buffer()[i] = tolower( buffer()[i] ); }
+    void toUpperCase() { for ( unsigned int i = 0; i < _len; i++ ) buffer()[i] = toupper( buffer()[i] ); }
+    void trim()
+    {
+      unsigned int a = 0, b = _len;
+      while ( a < b && isspace( (unsigned char) c_str()[a] ) )
+        a++;
+      while ( b > a && isspace( (unsigned char) c_str()[b - 1] ) )
+        b--;
+      memmove( buffer(), c_str() + a, b - a );
+      _len = b - a;
+      buffer()[_len] = '\0';
+    }
+    void replace( const String& from, const String& to )
+    {
+      String r;
+      const char* p = c_str();
+      const char* q = nullptr;
+      if ( from._len == 0 )
+        return;
+      while ( ( q = strstr( p, from.c_str() ) ) != nullptr )
+      {
+        r.concat( p, q - p );
+        r.concat( to );
+        p = q + from._len;
+      }
+      r.concat( p );
+      *this = r;
+    }
+    void remove( unsigned int from ) { remove( from, _len ); }
+    void remove( unsigned int from, unsigned int n )
+    {
+      if ( from >= _len )
+        return;
+      if ( n > _len - from )
+        n = _len - from;
+      memmove( buffer() + from, c_str() + from + n, _len - from - n + 1 );
+      _len -= n;
+    }
+    long toInt() const { return atol( c_str() ); }
+    float toFloat() const { return (float) atof( c_str() ); }
+    double toDouble() const { return atof( c_str() ); }
+    void toCharArray( char* buf, unsigned int size ) const { if ( size ) { strncpy( buf, c_str(), size - 1 ); buf[size - 1] = '\0'; } }
+
+    template <typename T> friend String operator+( const String& a, const T& b ) { String r( a ); r.concat( b ); return r; }
+    friend String operator+( const char* a, const String& b ) { String r( a ); r.concat( b ); return r; }
+
+  private:
+    static const unsigned int SSO_LENGTH = 10;
+    char _sso[ SSO_LENGTH + 1 ];
+    char* _heap;
+    unsigned int _len;
+    unsigned int _cap;
+
+    void init() { _sso[0] = '\0'; _heap = nullptr; _len = 0; _cap = SSO_LENGTH; }
+    char* buffer() { return ( _heap ) ? _heap : _sso; }
+    bool grow( unsigned int n )
+    {
+      if ( n <= SSO_LENGTH && !_heap )
+        return true;
+      char* p = (char*) realloc( _heap, n + 1 );
+      if ( !p )
+        return false;
+      if ( !_heap )
+        memcpy( p, _sso, _len + 1 );
+      _heap = p;
+      _cap = n;
+      return true;
+    }
+    void copy( const char* s, unsigned int n )
+    {
+      if ( !reserve( n ) )
+        return;
+      memmove( buffer(), s, n );
+      _len = n;
+      buffer()[n] = '\0';
+    }
+    void move( String& s )
+    {
+      free( _heap );
+      memcpy( _sso, s._sso, sizeof( _sso ) );
+      _heap = s._heap;
+      _len = s._len;
+      _cap = s._cap;
+      s.init();
+    }
+    void fromLong( long v, unsigned char base ) { if ( base == 10 ) concat( v ); else if ( v < 0 ) { concat( '-' ); fromULong( -v, base ); } else fromULong( v, base ); }
+    void fromULong( unsigned long v, unsigned char base ) { char b[40]; char* p = &b[39]; *p = '\0'; do { *--p = "0123456789abcdefghijklmnopqrstuvwxyz"[ v % base ]; v /= base; } while ( v ); concat( p ); }
+    void fromDouble( double v, unsigned char decimals ) { char b[48]; snprintf( b, sizeof( b ), "%.*f", decimals, v ); concat( b ); }
+};
+
+class Print
+{
+  public:
+    virtual ~Print() {}
+    virtual size_t write( uint8_t c ) = 0;
+    virtual size_t write( const uint8_t* buf, size_t n ) { size_t i = 0; for ( ; i < n; i++ ) write( buf[i] ); return n; }
+    size_t write( const char* s ) { return write( (const uint8_t*) s, strlen( s ) ); }
+    size_t print( const String& s ) { return write( (const uint8_t*) s.c_str(), s.length() ); }
+    size_t print( const char* s ) { return write( s ); }
+    size_t print( const __FlashStringHelper* s ) { return write( (const char*) s ); }
+    size_t print( char c ) { return write( (uint8_t) c ); }
+    size_t print( int v ) { return print( String( v ) ); }
+    size_t print( unsigned int v ) { return print( String( v ) ); }
+    size_t print( long v ) { return print( String( v ) ); }
+    size_t print( unsigned long v ) { return print( String( v ) ); }
+    size_t print( double v, int d = 2 ) { return print( String( v, (unsigned char) d ) ); }
+    template <typename T> size_t println( const T& v ) { size_t n = print( v ); return n + print( "\r\n" ); }
+    size_t println( void ) { return print( "\r\n" ); }
+    size_t printf( const char* format, ... ) __attribute__ ((format (printf, 2, 3)))
+    {
+      char buf[512];
+      va_list ap;
+      va_start( ap, format );
+      vsnprintf( buf, sizeof( buf ), format, ap );
+      va_end( ap );
+      return print( buf );
+    }
+    size_t printf_P( const char* format, ... ) __attribute__ ((format (printf, 2, 3)))
+    {
+      char buf[512];
+      va_list ap;
+      va_start( ap, format );
+      vsnprintf( buf, sizeof( buf ), format, ap );
+      va_end( ap );
+      return print( buf );
+    }
+};
+
+class Stream : public Print
+{
+  public:
+    virtual int available() { return 0; }
+    virtual int read() { return -1; }
+};
+
+#define SERIAL_8N1 0
+#define SERIAL_TX_ONLY 1
+
+//Serial output is dropped unless HOST_SERIAL is set in the environment - it would swamp the benchmark table
+class HardwareSerial : public Stream
+{
+  public:
+    void begin( unsigned long, int = 0, int = 0 ) { _echo = getenv( "HOST_SERIAL" ) != nullptr; }
+    size_t write( uint8_t c ) override { if ( _echo ) fputc( c, stderr ); return 1; }
+    void setDebugOutput( bool ) {}
+    void flush() {}
+  private:
+    bool _echo = false;
+};
+extern HardwareSerial Serial;
+
+#include "Esp.h"
+
+#endif
@@ -0,0 +1 @@
+//The sketch no longer uses ArduinoJson (see Webrelay_json.h) - nothing to stand in for
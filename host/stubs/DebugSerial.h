@@ -0,0 +1,15 @@
+//Stand-in for the Skybadger DebugSerial.h, for the host build
+#ifndef _HOST_DEBUGSERIAL_H_
+#define _HOST_DEBUGSERIAL_H_
+#include <Arduino.h>
+
+#if defined DEBUG_ESP_MH
+#define DEBUGS1(x) Serial.print(x)
+#define DEBUGSL1(x) Serial.println(x)
+#define DEBUG_ESP(...) Serial.printf(__VA_ARGS__)
+#else
+#define DEBUGS1(x)
+#define DEBUGSL1(x)
+#define DEBUG_ESP(...)
+#endif
+#endif
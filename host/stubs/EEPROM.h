@@ -0,0 +1,21 @@
+//Stand-in for the ESP8266 EEPROM library, for the host build - a RAM image, blank at each start
+#ifndef _HOST_EEPROM_H_
+#define _HOST_EEPROM_H_
+#include <Arduino.h>
+
+class EEPROMClass
+{
+  public:
+    void begin( size_t size ) { _size = ( size < sizeof( _data ) ) ? size : sizeof( _data ); memset( _data, 0xFF, sizeof( _data ) ); }
+    uint8_t read( int address ) { return ( address >= 0 && (size_t) address < _size ) ? _data[address] : 0; }
+    void write( int address, uint8_t value ) { if ( address >= 0 && (size_t) address < _size ) _data[address] = value; }
+    bool commit() { commits++; return true; }
+    template<typename T> T& get( int address, T& t ) { memcpy( (void*) &t, &_data[address], sizeof( T ) ); return t; }
+    template<typename T> const T& put( int address, const T& t ) { memcpy( &_data[address], (const void*) &t, sizeof( T ) ); return t; }
+    uint32_t commits = 0;
+  private:
+    uint8_t _data[4096];
+    size_t _size = 0;
+};
+extern EEPROMClass EEPROM;
+#endif
@@ -0,0 +1,23 @@
+//Stand-in for EEPROMAnything, for the host build
+#ifndef _HOST_EEPROMANYTHING_H_
+#define _HOST_EEPROMANYTHING_H_
+#include <EEPROM.h>
+
+template <class T> int EEPROM_writeAnything( int ee, const T& value )
+{
+  const uint8_t* p = (const uint8_t*) (const void*) &value;
+  unsigned int i;
+  for ( i = 0; i < sizeof( value ); i++ )
+    EEPROM.write( ee++, *p++ );
+  return i;
+}
+
+template <class T> int EEPROM_readAnything( int ee, T& value )
+{
+  uint8_t* p = (uint8_t*) (void*) &value;
+  unsigned int i;
+  for ( i = 0; i < sizeof( value ); i++ )
+    *p++ = EEPROM.read( ee++ );
+  return i;
+}
+#endif
@@ -0,0 +1,11 @@
+//Stand-in for ESP8266HTTPUpdateServer, for the host build - there is no firmware to update
+#ifndef _HOST_ESP8266HTTPUPDATESERVER_H_
+#define _HOST_ESP8266HTTPUPDATESERVER_H_
+#include <ESP8266WebServer.h>
+
+class ESP8266HTTPUpdateServer
+{
+  public:
+    void setup( ESP8266WebServer* ) {}
+};
+#endif
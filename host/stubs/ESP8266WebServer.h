@@ -0,0 +1,282 @@
+/*
+Stand-in for ESP8266WebServer, for the host build.
+There is no socket - hostRequest() takes the place of a client: it fills the arguments and collected headers from
+the request given, runs the first handler that accepts the request just as handleClient() would, and keeps the
+response in a fixed buffer for the caller to look at. Nothing here allocates while serving a request, so the
+allocations counted around hostRequest() are those of the handlers and what they ask of the server - a String
+returned by arg() or header() costs what it does on the device.
+*/
+#ifndef _HOST_ESP8266WEBSERVER_H_
+#define _HOST_ESP8266WEBSERVER_H_
+#include <ESP8266WiFi.h>
+#include <functional>
+#include <vector>
+
+enum HTTPMethod { HTTP_ANY, HTTP_GET, HTTP_HEAD, HTTP_POST, HTTP_PUT, HTTP_PATCH, HTTP_DELETE, HTTP_OPTIONS };
+
+#define CONTENT_LENGTH_UNKNOWN ((size_t) -1)
+#define CONTENT_LENGTH_NOT_SET ((size_t) -2)
+
+class ESP8266WebServer;
+
+class RequestHandler
+{
+  public:
+    virtual ~RequestHandler() {}
+    virtual bool canHandle( HTTPMethod method, const String& uri ) = 0;
+    virtual bool canUpload( const String& uri ) { (void) uri; return false; }
+    virtual bool handle( ESP8266WebServer& server, HTTPMethod requestMethod, const String& requestUri ) = 0;
+};
+
+class ESP8266WebServer
+{
+  public:
+    typedef std::function<void(void)> THandlerFunction;
+
+    static const int HOST_MAX_ARGS = 48;
+    static const int HOST_MAX_HEADERS = 8;
+    static const int HOST_NAME_SIZE = 32;
+    static const int HOST_VALUE_SIZE = 256;
+    static const size_t HOST_RESPONSE_SIZE = 32768;
+
+    ESP8266WebServer( int port = 80 ) : _port( port )
+    {
+      _uri.reserve( HOST_VALUE_SIZE );
+      for ( HostField& f : _args )
+        f.reserve();
+      for ( HostField& f : _headers )
+        f.reserve();
+    }
+
+    void begin() {}
+    void handleClient() {}
+    void on( const char* uri, THandlerFunction fn ) { on( uri, HTTP_ANY, fn ); }
+    void on( const char* uri, HTTPMethod method, THandlerFunction fn ) { _routes.push_back( new FunctionHandler( uri, method, fn ) ); addHandler( _routes.back() ); }
+    void addHandler( RequestHandler* handler ) { _handlers.push_back( handler ); }
+    void onNotFound( THandlerFunction fn ) { _notFound = fn; }
+    void collectHeaders( const char* names[], size_t count )
+    {
+      _headerCount = 0;
+      for ( size_t i = 0; i < count && _headerCount < HOST_MAX_HEADERS; i++ )
+        _headers[_headerCount++].name = names[i];
+    }
+
+    HTTPMethod method() { return _method; }
+    const String& uri() { return _uri; }
+    int args() { return _argCount; }
+    const String& arg( int i ) { return ( i >= 0 && i < _argCount ) ? _args[i].value : _empty; }
+    const String& argName( int i ) { return ( i >= 0 && i < _argCount ) ? _args[i].name : _empty; }
+    const String& arg( const String& name )
+    {
+      for ( int i = 0; i < _argCount; i++ )
+        if ( _args[i].name == name )
+          return _args[i].value;
+      return _empty;
+    }
+    bool hasArg( const String& name )
+    {
+      for ( int i = 0; i < _argCount; i++ )
+        if ( _args[i].name == name )
+          return true;
+      return false;
+    }
+    const String& header( const String& name )
+    {
+      for ( int i = 0; i < _headerCount; i++ )
+        if ( _headers[i].name.equalsIgnoreCase( name ) )
+          return _headers[i].value;
+      return _empty;
+    }
+
+    void setContentLength( size_t length ) { _contentLength = length; }
+    void sendHeader( const String& name, const String& value, bool first = false )
+    {
+      (void) first;
+      appendf( "%s: %s\r\n", name.c_str(), value.c_str() );
+    }
+    void send( int code, const char* contentType, const char* content ) { send( code, contentType, content, strlen( content ) ); }
+    void send( int code, const String& contentType, const String& content ) { send( code, contentType.c_str(), content.c_str(), content.length() ); }
+    void send_P( int code, PGM_P contentType, PGM_P content, size_t length ) { send( code, contentType, content, length ); }
+    void sendContent( const String& content ) { sendContent( content.c_str(), content.length() ); }
+    void sendContent( const char* content ) { sendContent( content, strlen( content ) ); }
+    void sendContent( const char* content, size_t length )
+    {
+      //Chunked after a send() of unknown length - the empty chunk ends the response
+      if ( _chunked && length > 0 )
+        appendf( "%x\r\n", (unsigned int) length );
+      append( content, length );
+      if ( _chunked )
+        append( "\r\n", 2 );
+      _bodyLength += length;
+    }
+
+    //In place of a client - run a request through the handlers and keep the response. query is the form encoded
+    //arguments, from the url or the body. ifNoneMatch is sent as the If-None-Match header if given.
+    int hostRequest( HTTPMethod method, const char* uri, const char* query, const char* ifNoneMatch = nullptr )
+    {
+      _method = method;
+      _uri = uri;
+      parseArgs( query );
+      for ( int i = 0; i < _headerCount; i++ )
+        _headers[i].value = ( strcasecmp( _headers[i].name.c_str(), "If-None-Match" ) == 0 && ifNoneMatch ) ? ifNoneMatch : "";
+      _responseLength = 0;
+      _responseCode = 0;
+      _bodyLength = 0;
+      _contentLength = CONTENT_LENGTH_NOT_SET;
+      _chunked = false;
+
+      for ( RequestHandler* handler : _handlers )
+      {
+        if ( handler->canHandle( method, _uri ) && handler->handle( *this, method, _uri ) )
+          return _responseCode;
+      }
+      if ( _notFound )
+        _notFound();
+      else
+        send( 404, "text/plain", "Not found" );
+      return _responseCode;
+    }
+    int responseCode() const { return _responseCode; }
+    const char* response() const { return _response; }
+    size_t responseLength() const { return _responseLength; }
+    size_t bodyLength() const { return _bodyLength; }
+
+  private:
+    class FunctionHandler : public RequestHandler
+    {
+      public:
+        FunctionHandler( const char* uri, HTTPMethod method, THandlerFunction fn ) : _uri( uri ), _method( method ), _fn( fn ) {}
+        bool canHandle( HTTPMethod method, const String& uri ) override
+        {
+          return ( _method == HTTP_ANY || _method == method ) && uri == _uri;
+        }
+        bool handle( ESP8266WebServer& server, HTTPMethod method, const String& uri ) override
+        {
+          (void) server;
+          if ( !canHandle( method, uri ) )
+            return false;
+          _fn();
+          return true;
+        }
+      private:
+        const char* _uri;
+        HTTPMethod _method;
+        THandlerFunction _fn;
+    };
+
+    //Held as Strings, as the server holds them, with room set aside up front so filling them allocates nothing
+    struct HostField
+    {
+      String name;
+      String value;
+      void reserve() { name.reserve( HOST_NAME_SIZE ); value.reserve( HOST_VALUE_SIZE ); }
+    };
+
+    int _port;
+    std::vector<RequestHandler*> _handlers;
+    std::vector<RequestHandler*> _routes;
+    THandlerFunction _notFound;
+    HTTPMethod _method = HTTP_GET;
+    String _uri;
+    HostField _args[ HOST_MAX_ARGS ];
+    int _argCount = 0;
+    HostField _headers[ HOST_MAX_HEADERS ];
+    int _headerCount = 0;
+    char _response[ HOST_RESPONSE_SIZE ];
+    size_t _responseLength = 0;
+    size_t _bodyLength = 0;
+    size_t _contentLength = CONTENT_LENGTH_NOT_SET;
+    bool _chunked = false;
+    int _responseCode = 0;
+    const String _empty;
+
+    static void decode( String& to, const char* from, size_t length )
+    {
+      char buf[ HOST_VALUE_SIZE ];
+      size_t n = 0;
+      for ( size_t i = 0; i < length && n + 1 < sizeof( buf ); i++ )
+      {
+        if ( from[i] == '+' )
+          buf[n++] = ' ';
+        else if ( from[i] == '%' && i + 2 < length && isxdigit( from[i + 1] ) && isxdigit( from[i + 2] ) )
+        {
+          char hex[3] = { from[i + 1], from[i + 2], '\0' };
+          buf[n++] = (char) strtol( hex, nullptr, 16 );
+          i += 2;
+        }
+        else
+          buf[n++] = from[i];
+      }
+      buf[n] = '\0';
+      to = buf;
+    }
+
+    void parseArgs( const char* query )
+    {
+      _argCount = 0;
+      while ( query && *query && _argCount < HOST_MAX_ARGS )
+      {
+        const char* end = strchr( query, '&' );
+        size_t length = ( end ) ? (size_t) ( end - query ) : strlen( query );
+        const char* equals = (const char*) memchr( query, '=', length );
+        size_t nameLength = ( equals ) ? (size_t) ( equals - query ) : length;
+
+        if ( nameLength > 0 )
+        {
+          decode( _args[_argCount].name, query, nameLength );
+          if ( equals )
+            decode( _args[_argCount].value, equals + 1, length - nameLength - 1 );
+          else
+            _args[_argCount].value = "";
+          _argCount++;
+        }
+        query = ( end ) ? end + 1 : nullptr;
+      }
+    }
+
+    void append( const char* data, size_t length )
+    {
+      if ( length > HOST_RESPONSE_SIZE - _responseLength )
+        length = HOST_RESPONSE_SIZE - _responseLength;
+      memcpy( &_response[_responseLength], data, length );
+      _responseLength += length;
+    }
+
+    void appendf( const char* format, ... ) __attribute__ ((format (printf, 2, 3)))
+    {
+      char line[ HOST_VALUE_SIZE + HOST_NAME_SIZE + 8 ];
+      va_list ap;
+      va_start( ap, format );
+      int n = vsnprintf( line, sizeof( line ), format, ap );
+      va_end( ap );
+      if ( n > 0 )
+        append( line, ( (size_t) n < sizeof( line ) ) ? (size_t) n : sizeof( line ) - 1 );
+    }
+
+    void send( int code, const char* contentType, const char* content, size_t length )
+    {
+      char headers[ HOST_VALUE_SIZE ];
+      size_t extra = _responseLength;
+
+      //The headers from sendHeader() go after the status line, as the server writes them
+      if ( extra > sizeof( headers ) )
+        extra = sizeof( headers );
+      memcpy( headers, _response, extra );
+      _responseLength = 0;
+      _responseCode = code;
+      appendf( "HTTP/1.1 %d\r\nContent-Type: %s\r\n", code, contentType );
+      append( headers, extra );
+      if ( _contentLength == CONTENT_LENGTH_UNKNOWN )
+      {
+        _chunked = true;
+        append( "Transfer-Encoding: chunked\r\n\r\n", 30 );
+        if ( length > 0 )
+          sendContent( content, length );
+        return;
+      }
+      appendf( "Content-Length: %u\r\n\r\n", (unsigned int) ( ( _contentLength == CONTENT_LENGTH_NOT_SET ) ? length : _contentLength ) );
+      append( content, length );
+      _bodyLength = length;
+    }
+};
+#endif
@@ -0,0 +1,52 @@
+//Stand-in for ESP8266WiFi, for the host build - the station is always connected
+#ifndef _HOST_ESP8266WIFI_H_
+#define _HOST_ESP8266WIFI_H_
+#include <Arduino.h>
+#include <user_interface.h>
+
+class IPAddress
+{
+  public:
+    IPAddress( uint32_t address = 0 ) : _address( address ) {}
+    IPAddress( uint8_t a, uint8_t b, uint8_t c, uint8_t d ) : _address( a | ( b << 8 ) | ( c << 16 ) | ( (uint32_t) d << 24 ) ) {}
+    operator uint32_t() const { return _address; }
+    String toString() const
+    {
+      char buf[16];
+      snprintf( buf, sizeof( buf ), "%u.%u.%u.%u", _address & 0xFF, ( _address >> 8 ) & 0xFF, ( _address >> 16 ) & 0xFF, _address >> 24 );
+      return String( buf );
+    }
+  private:
+    uint32_t _address;
+};
+
+enum WiFiMode_t { WIFI_OFF = 0, WIFI_STA = 1, WIFI_AP = 2, WIFI_AP_STA = 3 };
+enum wl_status_t { WL_IDLE_STATUS = 0, WL_CONNECTED = 3, WL_DISCONNECTED = 6 };
+
+class ESP8266WiFiClass
+{
+  public:
+    bool hostname( const char* name ) { _hostname = name; return true; }
+    bool hostname( const String& name ) { _hostname = name; return true; }
+    String hostname() { return _hostname; }
+    bool mode( WiFiMode_t ) { return true; }
+    wl_status_t begin( const char*, const char* = nullptr ) { return WL_CONNECTED; }
+    wl_status_t status() { return WL_CONNECTED; }
+    String SSID() { return "host"; }
+    int32_t RSSI() { return -50; }
+    IPAddress localIP() { return IPAddress( 127, 0, 0, 1 ); }
+    IPAddress dnsIP( uint8_t = 0 ) { return IPAddress( 127, 0, 0, 1 ); }
+  private:
+    String _hostname;
+};
+extern ESP8266WiFiClass WiFi;
+
+//No network on the host - the MQTT client sees a connection that accepts everything
+class WiFiClient
+{
+  public:
+    bool connected() { return true; }
+};
+
+inline void configTime( int, int, const char*, const char* = nullptr, const char* = nullptr ) {}
+#endif
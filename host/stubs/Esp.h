@@ -0,0 +1,58 @@
+/*
+Stand-in for the ESP8266 core EspClass, for the host build.
+Free heap is reported against a nominal ESP8266 heap from the allocations counted in host_main.cpp, and the flash is
+a set of sectors held in memory, erased on first use.
+*/
+#ifndef _HOST_ESP_H_
+#define _HOST_ESP_H_
+#include <map>
+#include <vector>
+
+const uint32_t HOST_HEAP_SIZE = 52000;
+const uint32_t HOST_FLASH_SECTOR_SIZE = 4096;
+extern size_t hostHeapInUse;
+extern uint32_t hostRestarts;
+
+class EspClass
+{
+  public:
+    uint32_t getFreeHeap() { return ( hostHeapInUse < HOST_HEAP_SIZE ) ? HOST_HEAP_SIZE - (uint32_t) hostHeapInUse : 0; }
+    uint8_t getHeapFragmentation() { return 0; }
+    String getResetReason() { return "Host start"; }
+    String getResetInfo() { return "Host start"; }
+    //The host build carries on rather than restarting - counted for the report
+    void restart() { hostRestarts++; }
+    void reset() { hostRestarts++; }
+
+    bool flashEraseSector( uint32_t sector )
+    {
+      _flash[sector].assign( HOST_FLASH_SECTOR_SIZE, 0xFF );
+      return true;
+    }
+    bool flashWrite( uint32_t address, const uint32_t* data, size_t size )
+    {
+      std::vector<uint8_t>& sector = flashSector( address );
+      const uint8_t* p = (const uint8_t*) data;
+      //Flash writes can only clear bits
+      for ( size_t i = 0; i < size; i++ )
+        sector[ ( address % HOST_FLASH_SECTOR_SIZE ) + i ] &= p[i];
+      return true;
+    }
+    bool flashRead( uint32_t address, uint32_t* data, size_t size )
+    {
+      memcpy( data, &flashSector( address )[ address % HOST_FLASH_SECTOR_SIZE ], size );
+      return true;
+    }
+
+  private:
+    std::map<uint32_t, std::vector<uint8_t>> _flash;
+
+    std::vector<uint8_t>& flashSector( uint32_t address )
+    {
+      std::vector<uint8_t>& sector = _flash[ address / HOST_FLASH_SECTOR_SIZE ];
+      if ( sector.empty() )
+        sector.assign( HOST_FLASH_SECTOR_SIZE, 0xFF );
+      return sector;
+    }
+};
+#endif
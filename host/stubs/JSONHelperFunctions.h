@@ -0,0 +1 @@
+//The sketch builds its json with Webrelay_json.h - nothing to stand in for
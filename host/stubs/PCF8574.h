@@ -0,0 +1,35 @@
+//Stand-in for the PCF8574 library, for the host build - an expander that is always present and keeps its outputs
+#ifndef _HOST_PCF8574_H_
+#define _HOST_PCF8574_H_
+#include <Wire.h>
+
+#define PCF8574_OK 0x00
+#define PCF8574_PIN_ERROR 0x81
+#define PCF8574_I2C_ERROR 0x82
+
+class PCF8574
+{
+  public:
+    PCF8574( const uint8_t address, TwoWire* wire = &Wire ) : _address( address ), _wire( wire ) {}
+    bool begin( uint8_t value = 0xFF ) { _data = value; return true; }
+    uint8_t read8() { return _data; }
+    void write8( const uint8_t value ) { _data = value; writes++; }
+    void write( const uint8_t pin, const uint8_t value )
+    {
+      if ( pin > 7 )
+      {
+        _error = PCF8574_PIN_ERROR;
+        return;
+      }
+      _data = ( value ) ? ( _data | ( 1 << pin ) ) : ( _data & ~( 1 << pin ) );
+      writes++;
+    }
+    int lastError() { int e = _error; _error = PCF8574_OK; return e; }
+    uint32_t writes = 0;
+  private:
+    uint8_t _address;
+    TwoWire* _wire;
+    uint8_t _data = 0xFF;
+    int _error = PCF8574_OK;
+};
+#endif
@@ -0,0 +1,31 @@
+//Stand-in for PubSubClient, for the host build - publishes are counted and dropped
+#ifndef _HOST_PUBSUBCLIENT_H_
+#define _HOST_PUBSUBCLIENT_H_
+#include <ESP8266WiFi.h>
+#include <functional>
+
+#if !defined MQTT_MAX_PACKET_SIZE
+#define MQTT_MAX_PACKET_SIZE 1024
+#endif
+#define MQTT_MAX_HEADER_SIZE 5
+
+class PubSubClient
+{
+  public:
+    typedef std::function<void(char*, uint8_t*, unsigned int)> CallbackFunction;
+    PubSubClient( WiFiClient& ) {}
+    PubSubClient& setServer( const char*, uint16_t ) { return *this; }
+    PubSubClient& setCallback( CallbackFunction fn ) { _callback = fn; return *this; }
+    bool connect( const char*, const char*, const char*, const char*, uint8_t, bool, const char* ) { _connected = true; return true; }
+    bool connect( const char* ) { _connected = true; return true; }
+    bool connected() { return _connected; }
+    bool loop() { return _connected; }
+    bool subscribe( const char* ) { return _connected; }
+    bool publish( const char*, const uint8_t*, unsigned int, bool ) { published++; return _connected; }
+    bool publish( const char*, const char* ) { published++; return _connected; }
+    uint32_t published = 0;
+  private:
+    bool _connected = false;
+    CallbackFunction _callback;
+};
+#endif
@@ -0,0 +1,33 @@
+//Stand-in for RemoteDebug, for the host build - output goes to Serial
+#ifndef _HOST_REMOTEDEBUG_H_
+#define _HOST_REMOTEDEBUG_H_
+#include <Arduino.h>
+
+class RemoteDebug : public Print
+{
+  public:
+    enum { PROFILER = 0, VERBOSE = 1, DEBUG = 2, INFO = 3, WARNING = 4, ERROR = 5, ANY = 6 };
+    bool begin( const char*, uint8_t = DEBUG ) { return true; }
+    void setSerialEnabled( bool ) {}
+    void setResetCmdEnabled( bool ) {}
+    void showProfiler( bool, uint32_t = 0 ) {}
+    void handle() {}
+    bool isActive( uint8_t ) { return true; }
+    size_t write( uint8_t c ) override { return Serial.write( c ); }
+};
+extern RemoteDebug Debug;
+
+#if defined DEBUG_DISABLED
+#define debugV(...)
+#define debugD(...)
+#define debugI(...)
+#define debugW(...)
+#define debugE(...)
+#else
+#define debugV(...) Debug.printf(__VA_ARGS__)
+#define debugD(...) Debug.printf(__VA_ARGS__)
+#define debugI(...) Debug.printf(__VA_ARGS__)
+#define debugW(...) Debug.printf(__VA_ARGS__)
+#define debugE(...) Debug.printf(__VA_ARGS__)
+#endif
+#endif
@@ -0,0 +1,16 @@
+//Stand-in for the Skybadger site settings, for the host build
+#ifndef _HOST_SKYBADGERSTRINGS_H_
+#define _HOST_SKYBADGERSTRINGS_H_
+const char* ssid2 = "host";
+const char* password2 = "host";
+const char* mqtt_server = "localhost";
+const char* pubsubUserID = "host";
+const char* pubsubUserPwd = "host";
+const char* timeServer1 = "pool.ntp.org";
+const char* timeServer2 = "pool.ntp.org";
+const char* timeServer3 = "pool.ntp.org";
+const char* inTopic = "skybadger/devices/in";
+const char* outHealthTopic = "skybadger/devices/health/";
+const char* outSenseTopic = "skybadger/sensors/";
+const char* outFnTopic = "skybadger/functions/";
+#endif
@@ -0,0 +1,34 @@
+//Stand-in for the Skybadger common functions, for the host build
+#ifndef _HOST_SKYBADGER_COMMON_FUNCS_H_
+#define _HOST_SKYBADGER_COMMON_FUNCS_H_
+#include <Arduino.h>
+#include <time.h>
+
+String& getTimeAsString( String& output )
+{
+  char buf[32];
+  time_t now = time( nullptr );
+  strftime( buf, sizeof( buf ), "%H:%M:%S", gmtime( &now ) );
+  output = buf;
+  return output;
+}
+
+String& getTimeAsString2( String& output )
+{
+  char buf[48];
+  time_t now = time( nullptr );
+  strftime( buf, sizeof( buf ), "%a %b %d %H:%M:%S %Y", gmtime( &now ) );
+  output = buf;
+  return output;
+}
+
+String scanI2CBus( void )
+{
+  return String( "Host build - no I2C bus to scan" );
+}
+
+void reconnectNB( void )
+{
+  client.connect( thisID );
+}
+#endif
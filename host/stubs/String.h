@@ -0,0 +1,2 @@
+//The sketch includes <String.h> for the C string functions
+#include <string.h>
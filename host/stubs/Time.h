@@ -0,0 +1,2 @@
+//Stand-in for the Time library, for the host build - the sketch uses the C library time functions
+#include <time.h>
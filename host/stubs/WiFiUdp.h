@@ -0,0 +1,23 @@
+//Stand-in for WiFiUdp, for the host build - no packets arrive, replies are counted
+#ifndef _HOST_WIFIUDP_H_
+#define _HOST_WIFIUDP_H_
+#include <ESP8266WiFi.h>
+
+class WiFiUDP
+{
+  public:
+    uint8_t begin( uint16_t port ) { _port = port; return 1; }
+    void stop() { _port = 0; }
+    int parsePacket() { return 0; }
+    int read( char*, size_t ) { return 0; }
+    int read( uint8_t*, size_t ) { return 0; }
+    IPAddress remoteIP() { return IPAddress( 127, 0, 0, 1 ); }
+    uint16_t remotePort() { return 0; }
+    int beginPacket( IPAddress, uint16_t ) { return 1; }
+    size_t write( const uint8_t*, size_t size ) { return size; }
+    int endPacket() { sent++; return 1; }
+    uint32_t sent = 0;
+  private:
+    uint16_t _port = 0;
+};
+#endif
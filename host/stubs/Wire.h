@@ -0,0 +1,33 @@
+/*
+Stand-in for the Wire library, for the host build.
+Every address acknowledges. Register reads answer as an ADS1015 would - the config register shows no conversion in
+progress and the conversion register holds a mid-range reading - which is all that Webrelay_adc.h asks of the bus.
+*/
+#ifndef _HOST_WIRE_H_
+#define _HOST_WIRE_H_
+#include <Arduino.h>
+
+class TwoWire
+{
+  public:
+    void begin( int = 0, int = 0 ) {}
+    void setClock( uint32_t ) {}
+    void beginTransmission( uint8_t address ) { _address = address; _written = 0; }
+    size_t write( uint8_t data ) { if ( _written++ == 0 ) _register = data; transfers++; return 1; }
+    uint8_t endTransmission( bool = true ) { return 0; }
+    uint8_t requestFrom( uint8_t, uint8_t quantity ) { _readIndex = 0; transfers += quantity; return quantity; }
+    int available() { return 2 - _readIndex; }
+    int read()
+    {
+      uint16_t value = ( _register == 0 ) ? 0x4000 : 0x8583;
+      return ( _readIndex++ == 0 ) ? ( value >> 8 ) : ( value & 0xFF );
+    }
+    uint32_t transfers = 0;
+  private:
+    uint8_t _address = 0;
+    uint8_t _register = 0;
+    int _written = 0;
+    int _readIndex = 0;
+};
+extern TwoWire Wire;
+#endif
@@ -0,0 +1,26 @@
+//Stand-in for the ESP8266 coredecls.h, for the host build
+#ifndef _HOST_COREDECLS_H_
+#define _HOST_COREDECLS_H_
+#include <stdint.h>
+#include <stddef.h>
+
+//As the core's crc32() - polynomial 0x04C11DB7, MSB first
+inline uint32_t crc32( const void* data, size_t length, uint32_t crc = 0xffffffff )
+{
+  const uint8_t* p = (const uint8_t*) data;
+  while ( length-- )
+  {
+    uint8_t c = *p++;
+    for ( uint32_t i = 0x80; i > 0; i >>= 1 )
+    {
+      bool bit = crc & 0x80000000;
+      if ( c & i )
+        bit = !bit;
+      crc <<= 1;
+      if ( bit )
+        crc ^= 0x04c11db7;
+    }
+  }
+  return crc;
+}
+#endif
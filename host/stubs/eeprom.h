@@ -0,0 +1,2 @@
+//Webrelay_eeprom.h includes the library by its lower case name
+#include <EEPROM.h>
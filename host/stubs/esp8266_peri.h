@@ -0,0 +1,6 @@
+//Stand-in for the ESP8266 register map, for the host build
+#ifndef _HOST_ESP8266_PERI_H_
+#define _HOST_ESP8266_PERI_H_
+#include <stdlib.h>
+#define RANDOM_REG32 ( (uint32_t) rand() )
+#endif
@@ -0,0 +1,2 @@
+//Stand-in for the ESP8266 pgmspace.h, for the host build - PROGMEM is ordinary memory here
+#include <Arduino.h>
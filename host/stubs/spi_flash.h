@@ -0,0 +1,5 @@
+//Stand-in for the ESP8266 spi_flash.h, for the host build - the flash itself is in EspClass
+#ifndef _HOST_SPI_FLASH_H_
+#define _HOST_SPI_FLASH_H_
+#define SPI_FLASH_SEC_SIZE 4096
+#endif
@@ -0,0 +1 @@
+//Stand-in for the core umm_malloc configuration, for the host build - heap figures come from EspClass
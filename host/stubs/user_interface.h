@@ -0,0 +1,19 @@
+//Stand-in for the ESP8266 SDK user_interface.h, for the host build
+#ifndef _HOST_USER_INTERFACE_H_
+#define _HOST_USER_INTERFACE_H_
+#include <stdint.h>
+#include <stdbool.h>
+
+enum sleep_type { NONE_SLEEP_T = 0, LIGHT_SLEEP_T, MODEM_SLEEP_T };
+inline bool wifi_set_sleep_type( enum sleep_type ) { return true; }
+
+typedef void ETSTimerFunc( void* arg );
+typedef struct
+{
+  ETSTimerFunc* func;
+  void* arg;
+} ETSTimer;
+inline void ets_timer_setfn( ETSTimer* t, ETSTimerFunc* fn, void* arg ) { t->func = fn; t->arg = arg; }
+inline void ets_timer_arm_new( ETSTimer*, uint32_t, bool, int ) {}
+inline void ets_timer_disarm( ETSTimer* ) {}
+#endif
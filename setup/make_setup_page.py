@@ -0,0 +1,68 @@
+#!/usr/bin/env python3
+"""
+Build Webrelay_setuppage.h from setup/setup.html for the ASCOM switch web driver.
+The page is minified - comments, indentation and blank lines dropped - then gzipped and written out as a PROGMEM byte
+array, which the device sends as-is with Content-Encoding: gzip. The ETag is the crc32 of the gzipped bytes so a
+browser holding an old copy fetches the new one after a firmware update.
+
+Run from anywhere after editing the page:
+  python3 setup/make_setup_page.py
+"""
+import gzip
+import os
+import re
+import sys
+import zlib
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+SOURCE = os.path.join(HERE, "setup.html")
+TARGET = os.path.join(HERE, "..", "Webrelay_setuppage.h")
+
+
+def minify(html):
+    html = re.sub(r"<!--.*?-->", "", html, flags=re.S)
+    lines = []
+    for line in html.splitlines():
+        line = line.strip()
+        # Whole line script comments only - a // inside a string or url is left alone
+        if not line or line.startswith("//"):
+            continue
+        lines.append(line)
+    return "\n".join(lines)
+
+
+def main():
+    with open(SOURCE, "r", encoding="utf-8") as f:
+        html = f.read()
+    page = minify(html).encode("utf-8")
+    # mtime=0 keeps the output, and so the ETag, the same for the same page
+    packed = gzip.compress(page, compresslevel=9, mtime=0)
+    etag = "%08x" % (zlib.crc32(packed) & 0xFFFFFFFF)
+
+    out = []
+    out.append("/*")
+    out.append("Generated by setup/make_setup_page.py from setup/setup.html - do not edit, re-run the script instead.")
+    out.append("%d bytes of html, %d gzipped." % (len(page), len(packed)))
+    out.append("*/")
+    out.append("#ifndef _WEBRELAY_SETUPPAGE_H_")
+    out.append("#define _WEBRELAY_SETUPPAGE_H_")
+    out.append("")
+    out.append("#include <pgmspace.h>")
+    out.append("")
+    out.append('#define SETUP_PAGE_ETAG "\\"%s\\""' % etag)
+    out.append("const size_t SETUP_PAGE_LENGTH = %d;" % len(packed))
+    out.append("const uint8_t setupPage[] PROGMEM =")
+    out.append("{")
+    for i in range(0, len(packed), 16):
+        out.append("  " + ", ".join("0x%02x" % b for b in packed[i:i + 16]) + ",")
+    out.append("};")
+    out.append("#endif")
+
+    with open(TARGET, "w", encoding="utf-8", newline="\n") as f:
+        f.write("\n".join(out) + "\n")
+    print("%s: %d bytes -> %d gzipped, etag %s" % (os.path.normpath(TARGET), len(page), len(packed), etag))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,176 @@
+/*
+Decoder for the binary MQTT telemetry payloads defined in Webrelay_telemetry.h - prints each one as a json line.
+Build on a linux host with:
+  cc -O2 -o telemetry_decode telemetry_decode.c
+Use with mosquitto_sub printing topic and hex payload, one message per line:
+  mosquitto_sub -h broker -t 'skybadger/#' -F '%t %x' | ./telemetry_decode
+or decode a single raw payload from stdin with -r:
+  mosquitto_sub -h broker -t 'skybadger/sensors/voltage/espASW02' -C 1 -N | ./telemetry_decode -r
+Json payloads are printed as text and anything else is passed through unchanged.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <stddef.h>
+#include "Webrelay_telemetry.h"
+
+#define MAX_PAYLOAD 1024
+
+static int hexValue( int c )
+{
+  if ( c >= '0' && c <= '9' )
+    return c - '0';
+  c = tolower( c );
+  if ( c >= 'a' && c <= 'f' )
+    return c - 'a' + 10;
+  return -1;
+}
+
+/* Returns the number of bytes decoded, or -1 if the text isn't all hex pairs */
+static int fromHex( const char* text, uint8_t* out, size_t size )
+{
+  size_t n = 0;
+
+  while ( *text && !isspace( (unsigned char) *text ) )
+  {
+    int hi = hexValue( text[0] );
+    int lo = ( hi < 0 ) ? -1 : hexValue( text[1] );
+    if ( lo < 0 || n >= size )
+      return -1;
+    out[n++] = (uint8_t) ( ( hi << 4 ) | lo );
+    text += 2;
+  }
+  return (int) n;
+}
+
+static void printTopic( const char* topic )
+{
+  if ( topic != NULL )
+    printf( "\"topic\":\"%s\",", topic );
+}
+
+/* Returns 0 if the payload isn't a telemetry message this decoder understands */
+static int decode( const char* topic, const uint8_t* data, size_t length )
+{
+  TelemetryHeader header;
+  int i = 0;
+
+  if ( length < sizeof( header ) )
+    return 0;
+  memcpy( &header, data, sizeof( header ) );
+  if ( header.version != TELEMETRY_VERSION || header.length != length )
+    return 0;
+
+  switch ( header.type )
+  {
+    case TELEMETRY_HEALTH:
+    {
+      TelemetryHealth msg;
+      if ( length != sizeof( msg ) )
+        return 0;
+      memcpy( &msg, data, sizeof( msg ) );
+      printf( "{" );
+      printTopic( topic );
+      printf( "\"type\":\"health\",\"time\":%u,\"uptime\":%u,\"freeHeap\":%u,\"mqttDropped\":%u}\n",
+              msg.header.time, msg.uptime, msg.freeHeap, msg.mqttDropped );
+      return 1;
+    }
+    case TELEMETRY_VOLTAGE:
+    {
+      TelemetryVoltage msg;
+      memset( &msg, 0, sizeof( msg ) );
+      if ( length < offsetof( TelemetryVoltage, channel ) || length > sizeof( msg ) )
+        return 0;
+      memcpy( &msg, data, length );
+      if ( msg.channels > TELEMETRY_MAX_ADC_CHANNELS ||
+           length != offsetof( TelemetryVoltage, channel ) + msg.channels * sizeof( TelemetryChannel ) )
+        return 0;
+      printf( "{" );
+      printTopic( topic );
+      printf( "\"type\":\"voltage\",\"time\":%u,\"channels\":[", msg.header.time );
+      for ( i = 0; i < msg.channels; i++ )
+      {
+        TelemetryChannel* ch = &msg.channel[i];
+        printf( "%s{\"channel\":%d,\"voltage\":%.3f,\"voltageMean\":%.3f,\"voltageMin\":%.3f,\"voltageMax\":%.3f,\"raw\":%u,\"gain\":%u}",
+                ( i == 0 ) ? "" : ",", i, ch->millivolts / 1000.0, ch->meanMv / 1000.0, ch->minMv / 1000.0, ch->maxMv / 1000.0,
+                ch->raw, ch->gain );
+      }
+      printf( "]}\n" );
+      return 1;
+    }
+    case TELEMETRY_SWITCH:
+    {
+      TelemetrySwitch msg;
+      if ( length != sizeof( msg ) )
+        return 0;
+      memcpy( &msg, data, sizeof( msg ) );
+      printf( "{" );
+      printTopic( topic );
+      printf( "\"type\":\"switch\",\"time\":%u,\"id\":%u,\"switchType\":%u,\"state\":%s,\"value\":%g}\n",
+              msg.header.time, msg.id, msg.type, ( msg.state ) ? "true" : "false", msg.value );
+      return 1;
+    }
+    default:
+      return 0;
+  }
+}
+
+int main( int argc, char** argv )
+{
+  static uint8_t payload[ MAX_PAYLOAD ];
+  static char line[ 2 * MAX_PAYLOAD + 256 ];
+
+  if ( argc > 1 && strcmp( argv[1], "-r" ) == 0 )
+  {
+    size_t length = fread( payload, 1, sizeof( payload ), stdin );
+    if ( !decode( NULL, payload, length ) )
+    {
+      fprintf( stderr, "telemetry_decode: not a telemetry payload\n" );
+      return 1;
+    }
+    return 0;
+  }
+  if ( argc > 1 )
+  {
+    fprintf( stderr, "usage: telemetry_decode [-r] < input\n" );
+    return 2;
+  }
+
+  while ( fgets( line, sizeof( line ), stdin ) != NULL )
+  {
+    char* topic = NULL;
+    char* hex = line;
+    char* space = strchr( line, ' ' );
+    int length = 0;
+
+    line[ strcspn( line, "\r\n" ) ] = '\0';
+    if ( space != NULL )
+    {
+      *space = '\0';
+      topic = line;
+      hex = space + 1;
+    }
+    length = fromHex( hex, payload, sizeof( payload ) );
+    if ( length > 0 && decode( topic, payload, (size_t) length ) )
+    {
+      fflush( stdout );
+      continue;
+    }
+    if ( length > 0 && payload[0] == '{' )
+    {
+      /* A json topic - print it as text */
+      if ( topic != NULL )
+        printf( "%s ", topic );
+      printf( "%.*s\n", length, (const char*) payload );
+    }
+    else
+    {
+      if ( space != NULL )
+        *space = ' ';
+      printf( "%s\n", line );
+    }
+    fflush( stdout );
+  }
+  return 0;
+}
@@ -95,6 +95,12 @@ curl -X PUT -d "ClientID=99&ClientTransactionID=123&Id=0&state=false" "http://es
 curl -X PUT -d "ClientID=99&ClientTransactionID=123&Id=0&state=true" "http://espasw01/api/v1/switch/0/setswitch"
 curl -X PUT -d "ClientID=99&ClientTransactionID=123&Id=1&state=true" "http://espasw01/api/v1/switch/0/setswitch"
 
+ECHO "Testing batch set - one request, one bus write"
+curl -X PUT -d "ClientID=99&ClientTransactionID=123&Id=0&State=true&Id=1&State=true&Id=2&State=false&Id=3&State=true" "http://espasw01/api/v1/switch/0/setswitches"
+timeout /t 2
+curl -X PUT -d "ClientID=99&ClientTransactionID=123&Id=0&State=false&Id=9&State=true" "http://espasw01/api/v1/switch/0/setswitches"
+timeout /t 2
+
 REM still to be tested
 REM Non-ascom - yet to be tested 
 REM status - works 